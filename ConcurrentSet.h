@@ -0,0 +1,220 @@
+#ifndef CONCURRENT_SET_H
+#define CONCURRENT_SET_H
+#include <atomic>
+#include <mutex>
+#include <shared_mutex>
+#include <ostream>
+#include "Set.h"
+/**
+ * @brief Classe ConcurrentSet
+ *
+ * Set utilizzabile contemporaneamente da più thread lettori e scrittori.
+ * Gli elementi sono distribuiti, secondo il loro hash rimescolato, in Stripes
+ * partizioni indipendenti: ogni partizione è un Set indicizzato protetto dal
+ * proprio std::shared_mutex, quindi operazioni su valori di partizioni diverse
+ * non si contendono alcun lock e le letture (contains, for_each, snapshot)
+ * sulla stessa partizione procedono in parallelo. Il numero di elementi è un
+ * contatore atomico.
+ *
+ * A differenza di Set non esiste un ordine di inserimento globale:
+ * l'iterazione avviene tramite for_each (una partizione alla volta) oppure su
+ * una copia ottenuta con snapshot()
+ *
+ * @tparam T tipo degli elementi
+ * @tparam Eql funtore di uguaglianza tra due valori di tipo T
+ * @tparam Hash funtore hash su T, coerente con Eql
+ * @tparam Stripes numero di partizioni (potenza di 2)
+ */
+template<typename T, typename Eql, typename Hash, unsigned int Stripes = 64> class ConcurrentSet{
+    static_assert(Stripes > 0 && (Stripes & (Stripes - 1)) == 0, "Stripes deve essere una potenza di 2");
+
+    /**
+     * @brief Partizione: un set e il mutex che lo protegge,
+     * allineati alla linea di cache per evitare false sharing tra partizioni
+     */
+    struct alignas(64) stripe{
+        mutable std::shared_mutex mutex;///< protegge values: condiviso in lettura, esclusivo in scrittura
+        Set<T, Eql, Hash> values;///< elementi della partizione
+    };
+
+#ifdef SET_INSTRUMENTATION
+    typedef std::unique_lock<std::shared_mutex> read_lock;///< i contatori di Set vengono scritti anche dalle letture
+#else
+    typedef std::shared_lock<std::shared_mutex> read_lock;///< lock delle operazioni di sola lettura
+#endif
+
+    stripe _stripes[Stripes];///< partizioni
+    std::atomic<unsigned int> _size;///< numero di elementi salvati
+    Hash _hash;///< funtore hash sui valori di tipo T
+
+    /**
+     * @brief Partizione a cui appartiene un valore
+     *
+     * L'hash viene rimescolato con il finalizzatore di splitmix64 e non con la
+     * moltiplicazione di Fibonacci usata da Set::slot_of per la tabella interna:
+     * altrimenti i valori di una partizione avrebbero quasi costanti i bit che
+     * scelgono lo slot e la scansione lineare degenererebbe in un unico cluster
+     *
+     * @param value valore
+     * @return reference alla partizione
+     */
+    stripe& stripe_of(const T &value){
+        unsigned long long h = static_cast<unsigned long long>(_hash(value));
+        h = (h ^ (h >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        h = (h ^ (h >> 27)) * 0x94D049BB133111EBULL;
+        h ^= h >> 31;
+        return _stripes[static_cast<unsigned int>(h) & (Stripes - 1)];
+    }
+    /**
+     * @brief Partizione a cui appartiene un valore (versione costante)
+     */
+    const stripe& stripe_of(const T &value) const{
+        return const_cast<ConcurrentSet*>(this)->stripe_of(value);
+    }
+
+    ConcurrentSet(const ConcurrentSet &);
+    ConcurrentSet& operator=(const ConcurrentSet &);
+
+public:
+    /**
+     * @brief Costruttore di default
+     *
+     * @post size() == 0
+     */
+    ConcurrentSet() : _size(0) {}
+
+    /**
+     * @brief Costruttore secondario, costruisce un set a partire da due iteratori sul tipo Q
+     *
+     * @tparam Q tipo dell'iteratore
+     * @param b iteratore di inizio
+     * @param e iteratore di fine
+     * @throw std::bad_alloc possibile eccezione di allocazione
+     */
+    template<typename Q> ConcurrentSet(Q b, Q e) : _size(0){
+        for(; b!=e; ++b)
+            add(static_cast<T>(*b));
+    }
+    /**
+     * @brief Aggiunge un valore solo se non è presente
+     *
+     * La verifica e l'inserimento avvengono sotto lo stesso lock: tra più
+     * thread che aggiungono lo stesso valore, esattamente uno ottiene true
+     *
+     * @param value valore da memorizzare
+     * @return true se il valore è stato aggiunto
+     * @throw std::bad_alloc possibile eccezione di allocazione
+     */
+    bool add(const T &value){
+        stripe &s = stripe_of(value);
+        std::unique_lock<std::shared_mutex> lock(s.mutex);
+        unsigned int before = s.values.size();
+        s.values.add(value);
+        if (s.values.size() == before)
+            return false;
+        _size++;
+        return true;
+    }
+    /**
+     * @brief Rimuove il valore passato solo se è presente
+     *
+     * @param value valore da rimuovere
+     * @return true se il valore è stato rimosso
+     */
+    bool remove(const T &value){
+        stripe &s = stripe_of(value);
+        std::unique_lock<std::shared_mutex> lock(s.mutex);
+        unsigned int before = s.values.size();
+        s.values.remove(value);
+        if (s.values.size() == before)
+            return false;
+        _size--;
+        return true;
+    }
+    /**
+     * @brief Verifica se il valore passato è contenuto nel set
+     *
+     * Blocca in lettura solo la partizione del valore: più lettori della
+     * stessa partizione non si escludono
+     *
+     * @param value valore da cercare
+     * @return true se il valore è presente
+     * @return false se il valore non è presente
+     */
+    bool contains(const T &value) const{
+        const stripe &s = stripe_of(value);
+        read_lock lock(s.mutex);
+        return s.values.contains(value);
+    }
+    /**
+     * @brief Numero degli elementi salvati
+     *
+     * @return valore del contatore al momento della lettura
+     */
+    unsigned int size() const{
+        return _size.load();
+    }
+    /**
+     * @brief Verifica che il set sia vuoto
+     *
+     * @return true se il set è vuoto
+     */
+    bool isEmpty() const{
+        return size() == 0;
+    }
+    /**
+     * @brief Svuota il set, una partizione alla volta
+     */
+    void clear(){
+        for (unsigned int i = 0; i < Stripes; ++i){
+            std::unique_lock<std::shared_mutex> lock(_stripes[i].mutex);
+            _size -= _stripes[i].values.size();
+            _stripes[i].values.clear();
+        }
+    }
+    /**
+     * @brief Applica f a tutti gli elementi
+     *
+     * Ogni partizione resta bloccata in lettura mentre f visita i suoi elementi:
+     * f non deve modificare il set. Gli elementi aggiunti o rimossi in partizioni non
+     * ancora visitate possono essere visti o meno
+     *
+     * @tparam F tipo del funtore, invocabile con const T&
+     * @param f funtore da applicare
+     */
+    template<typename F>
+    void for_each(F f) const{
+        for (unsigned int i = 0; i < Stripes; ++i){
+            read_lock lock(_stripes[i].mutex);
+            typename Set<T, Eql, Hash>::const_iterator b, e;
+            for (b = _stripes[i].values.begin(), e = _stripes[i].values.end(); b != e; ++b)
+                f(*b);
+        }
+    }
+    /**
+     * @brief Copia degli elementi in un Set, iterabile con const_iterator
+     *
+     * @return Set<T, Eql, Hash> set con gli elementi presenti durante la visita
+     * @throw std::bad_alloc possibile eccezione di allocazione
+     */
+    Set<T, Eql, Hash> snapshot() const{
+        Set<T, Eql, Hash> copy;
+        for (unsigned int i = 0; i < Stripes; ++i){
+            read_lock lock(_stripes[i].mutex);
+            copy += _stripes[i].values;
+        }
+        return copy;
+    }
+    /**
+     * @brief Operatore di stream
+     * @param os stream di output
+     * @param s set da spedire sullo stream
+     * @return reference dello stream di output
+     */
+    friend std::ostream& operator<<(std::ostream &os, const ConcurrentSet &s){
+        s.for_each([&os](const T &value){ os<<value<<" "; });
+        return os;
+    }
+};
+
+#endif
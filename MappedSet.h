@@ -0,0 +1,352 @@
+#ifndef MAPPED_SET_H
+#define MAPPED_SET_H
+#include <cstddef> // std::size_t
+#include <cstdint>
+#include <cstring> // std::memcpy
+#include <ios> // std::ios_base::failure
+#include <iterator> // std::forward_iterator_tag
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <unordered_set>
+#include <fcntl.h> // open
+#include <sys/mman.h> // mmap, munmap
+#include <sys/stat.h> // fstat
+#include <unistd.h> // close
+#include "set_io.h"
+/**
+ * @brief Classe MappedSet
+ *
+ * Vista in sola lettura di un set salvato con save: il file viene mappato in
+ * memoria con mmap e contains e l'iterazione leggono direttamente dalle pagine
+ * mappate, senza copiare gli elementi né allocare nodi. L'apertura scorre una
+ * volta gli elementi, O(n), per verificare che il numero dichiarato sia esatto
+ * e che non ci siano duplicati: tramite la tabella e Eql se la tabella è
+ * utilizzabile, altrimenti confrontando i byte degli elementi (due elementi
+ * uguali per Eql ma con byte diversi sono riconosciuti solo con la tabella).
+ * Se il file contiene la tabella hash (set salvato indicizzato) e Hash non è
+ * no_hash, contains costa O(1) in media; altrimenti è una scansione lineare.
+ * La tabella viene usata solo se Hash riproduce l'hash_check del file (cioè
+ * coincide con il funtore del set salvato sui primi elementi): con un funtore
+ * diverso contains ripiega sulla scansione lineare invece di dare falsi negativi.
+ * Le letture dalla mappatura sono controllate: un file corrotto provoca
+ * std::ios_base::failure, mai accessi fuori dalla mappatura o cicli infiniti.
+ * Gli elementi vengono restituiti come binary_codec<T>::mapped_type: T per i
+ * tipi trivially copyable, std::string_view (che punta al file) per std::string
+ *
+ * @tparam T tipo degli elementi
+ * @tparam Eql funtore di uguaglianza tra due valori di tipo T (per le stringhe si confrontano i byte)
+ * @tparam Hash funtore hash usato dal set salvato, no_hash per non usare la tabella
+ */
+template<typename T, typename Eql, typename Hash = no_hash> class MappedSet{
+    typedef binary_codec<T> codec;
+    typedef typename codec::mapped_type mapped_type;
+
+    static const std::uint64_t not_found = ~std::uint64_t(0);///< risultato di indexed_find per un valore assente
+
+    const char *_data;///< inizio della mappatura
+    std::size_t _length;///< byte mappati
+    binary_header _header;///< intestazione del file
+    const char *_payload;///< primo elemento
+    const char *_table;///< tabella hash, nullptr se assente o non utilizzabile
+    Eql _equals;///< funtore di uguaglianza tra due valori di tipo T
+    Hash _hash;///< funtore hash sui valori di tipo T
+
+    /**
+     * @brief Uguaglianza tra un elemento mappato e un valore cercato
+     */
+    bool same(const std::string_view &mapped, const std::string &value) const{
+        return mapped == value;
+    }
+    template<typename U>
+    bool same(const U &mapped, const T &value) const{
+        return _equals(mapped, value);
+    }
+    /**
+     * @brief Elemento che inizia offset byte dopo l'inizio degli elementi, controllato
+     *
+     * @throw std::ios_base::failure se l'elemento non sta negli elementi dichiarati
+     */
+    const char* element_at(std::uint64_t offset) const{
+        if (offset >= _header.payload_bytes
+            || codec::checked_size(_payload + offset, _header.payload_bytes - offset) == 0)
+            throw std::ios_base::failure("Corrupt binary set");
+        return _payload + offset;
+    }
+    /**
+     * @brief Cerca value tramite la tabella
+     *
+     * @return offset del primo elemento uguale a value, oppure not_found
+     * @throw std::ios_base::failure se la tabella non ha slot vuoti
+     */
+    std::uint64_t indexed_find(const T &value) const{
+        std::uint64_t mask = _header.table_capacity - 1;
+        std::uint64_t slot = binary_slot(_hash(value), _header.table_capacity);
+        for (std::uint64_t probes = 0; probes < _header.table_capacity; ++probes, slot = (slot + 1) & mask){
+            std::uint64_t entry;
+            std::memcpy(&entry, _table + slot * sizeof(entry), sizeof(entry));
+            if (entry == 0)
+                return not_found;
+            if (same(codec::view(element_at(entry - 1)), value))
+                return entry - 1;
+        }
+        throw std::ios_base::failure("Corrupt binary set"); //tabella senza slot vuoti
+    }
+    /**
+     * @brief Verifica che gli elementi siano esattamente count e tutti distinti
+     *
+     * @throw std::ios_base::failure se il file è corrotto
+     */
+    void validate_elements() const{
+        std::unordered_set<std::string_view> encodings; //usato solo senza tabella
+        std::uint64_t count = 0;
+        for (std::uint64_t offset = 0; offset < _header.payload_bytes; ++count){
+            std::size_t size = codec::checked_size(_payload + offset, _header.payload_bytes - offset);
+            if (size == 0)
+                throw std::ios_base::failure("Corrupt binary set");
+            //con la tabella ogni elemento deve essere il primo uguale a sé raggiungibile dal suo slot
+            bool unique = _table != nullptr ? indexed_find(T(codec::view(_payload + offset))) == offset
+                                            : encodings.insert(std::string_view(_payload + offset, size)).second;
+            if (!unique)
+                throw std::ios_base::failure("Corrupt binary set"); //elemento duplicato
+            offset += size;
+        }
+        if (count != _header.count)
+            throw std::ios_base::failure("Corrupt binary set");
+    }
+    /**
+     * @brief Rilascia la mappatura
+     */
+    void unmap(){
+        if (_data != nullptr)
+            munmap(const_cast<char*>(_data), _length);
+        _data = nullptr;
+        _length = 0;
+    }
+
+    MappedSet(const MappedSet &);
+    MappedSet& operator=(const MappedSet &);
+
+public:
+    /**
+     * @brief Mappa in memoria il file passato
+     *
+     * @param path percorso di un file scritto da save
+     * @throw std::ios_base::failure se il file non può essere aperto o mappato,
+     * non è un set binario di elementi di tipo T oppure è corrotto (numero di
+     * elementi diverso da quello dichiarato, elementi duplicati)
+     */
+    explicit MappedSet(const std::string &path) : _data(nullptr), _length(0), _payload(nullptr), _table(nullptr){
+        int fd = open(path.c_str(), O_RDONLY);
+        if (fd < 0)
+            throw std::ios_base::failure("Cannot open " + path);
+        struct stat st;
+        if (fstat(fd, &st) != 0 || static_cast<std::size_t>(st.st_size) < sizeof(binary_header)){
+            close(fd);
+            throw std::ios_base::failure("Not a binary set: " + path);
+        }
+        _length = static_cast<std::size_t>(st.st_size);
+        void *p = mmap(nullptr, _length, PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd); //la mappatura resta valida dopo la chiusura
+        if (p == MAP_FAILED){
+            _length = 0;
+            throw std::ios_base::failure("Cannot map " + path);
+        }
+        _data = static_cast<const char*>(p);
+        std::memcpy(&_header, _data, sizeof(_header));
+        std::uint64_t available = _length - sizeof(_header);
+        std::uint64_t capacity = _header.table_capacity;
+        if (std::memcmp(_header.magic, "SETB", 4) != 0 || _header.version != binary_format_version
+            || _header.kind != codec::kind || _header.value_size != codec::value_size
+            || _header.payload_bytes > available
+            || capacity > (available - _header.payload_bytes) / sizeof(std::uint64_t)
+            || sizeof(_header) + _header.payload_bytes + capacity * sizeof(std::uint64_t) != _length){
+            unmap();
+            throw std::ios_base::failure("Not a compatible binary set: " + path);
+        }
+        //tabella: potenza di 2 con almeno uno slot vuoto; elementi a dimensione fissa: count coerente
+        if ((capacity & (capacity - 1)) != 0 || (capacity > 0 && capacity <= _header.count)
+            || (codec::kind == 0 && _header.payload_bytes != _header.count * codec::value_size)){
+            unmap();
+            throw std::ios_base::failure("Corrupt binary set: " + path);
+        }
+        _payload = _data + sizeof(_header);
+        if (capacity > 0 && !std::is_same<Hash, no_hash>::value){
+            try{
+                std::uint64_t check = binary_hash_check([this](const mapped_type &v){ return _hash(T(v)); }, begin(), end());
+                if (check == _header.hash_check)
+                    _table = _payload + _header.payload_bytes;
+            }catch(...){
+                unmap();
+                throw;
+            }
+        }
+        try{
+            validate_elements();
+        }catch(...){
+            unmap();
+            throw;
+        }
+    }
+    /**
+     * @brief Move constructor, si appropria della mappatura di other
+     *
+     * @param other set da cui spostare la mappatura
+     */
+    MappedSet(MappedSet &&other) noexcept : _data(other._data), _length(other._length), _header(other._header),
+        _payload(other._payload), _table(other._table){
+        other._data = nullptr;
+        other._length = 0;
+        other._header.count = 0;
+        other._payload = nullptr;
+        other._table = nullptr;
+    }
+    /**
+     * @brief Distruttore, rilascia la mappatura
+     */
+    ~MappedSet(){
+        unmap();
+    }
+    /**
+     * @brief Numero degli elementi salvati, verificato all'apertura
+     *
+     * @return numero di elementi distinti
+     */
+    unsigned int size() const{
+        return static_cast<unsigned int>(_header.count);
+    }
+    /**
+     * @brief Verifica che il set sia vuoto
+     *
+     * @return true se il set è vuoto
+     */
+    bool isEmpty() const{
+        return _header.count == 0;
+    }
+
+    class const_iterator;
+    /**
+     * @brief Verifica se il valore passato è contenuto nel set
+     *
+     * @param value valore da cercare
+     * @return true se il valore è presente
+     * @return false se il valore non è presente
+     * @throw std::ios_base::failure se il file è corrotto
+     */
+    bool contains(const T &value) const{
+        if (_table != nullptr)
+            return indexed_find(value) != not_found;
+        for (const_iterator b = begin(), e = end(); b != e; ++b)
+            if (same(*b, value))
+                return true;
+        return false;
+    }
+
+    /**
+     * @brief Iteratore costante in avanti sugli elementi mappati, in ordine di inserimento
+     */
+    class const_iterator{
+        public:
+            typedef std::forward_iterator_tag iterator_category;
+            typedef mapped_type               value_type;
+            typedef ptrdiff_t                 difference_type;
+            typedef const mapped_type*        pointer;
+            typedef mapped_type               reference;
+
+            /**
+             * @brief Costruttore di default
+             *
+             */
+            const_iterator() : ptr(nullptr), end(nullptr) {}
+
+            /**
+             * @brief Operatore*
+             *
+             * @return elemento riferito dall'iteratore, letto dalla mappatura
+             * @throw std::ios_base::failure se l'elemento esce dalla mappatura (file corrotto)
+             */
+            reference operator*() const{
+                if (codec::checked_size(ptr, static_cast<std::uint64_t>(end - ptr)) == 0)
+                    throw std::ios_base::failure("Corrupt binary set");
+                return codec::view(ptr);
+            }
+            /**
+             * @brief Operatore++ di post-incremento
+             * @return copia dell'iteratore che punta al valore precedente
+             */
+            const_iterator operator++(int){
+                const_iterator tmp(*this);
+                ++*this;
+                return tmp;
+            }
+            /**
+             * @brief Operatore++ pre-incremento
+             * @return reference all'iteratore this
+             * @throw std::ios_base::failure se l'elemento esce dalla mappatura (file corrotto)
+             */
+            const_iterator& operator++(){
+                std::size_t size = codec::checked_size(ptr, static_cast<std::uint64_t>(end - ptr));
+                if (size == 0)
+                    throw std::ios_base::failure("Corrupt binary set");
+                ptr += size;
+                return *this;
+            }
+            /**
+             * @brief Operatore==
+             *
+             * @param other iteratore da confrontare
+             * @return true se i due iteratori puntano allo stesso elemento
+             */
+            bool operator==(const const_iterator &other) const{
+                return ptr == other.ptr;
+            }
+            /**
+             * @brief Operatore!=
+             *
+             * @param other iteratore da confrontare
+             * @return true se i due iteratori puntano a elementi diversi
+             */
+            bool operator!=(const const_iterator &other) const{
+                return ptr != other.ptr;
+            }
+
+        private:
+            friend class MappedSet;
+
+            const char *ptr;///< inizio dell'elemento corrente nella mappatura
+            const char *end;///< fine degli elementi: limite dei salti di operator++
+
+            const_iterator(const char *p, const char *e) : ptr(p), end(e) {}
+    };
+
+    /**
+     * @brief Iteratore di inizio
+     *
+     * @return iteratore al primo elemento
+     */
+    const_iterator begin() const{
+        return const_iterator(_payload, end().ptr);
+    }
+    /**
+     * @brief Iteratore di fine
+     *
+     * @return iteratore successivo all'ultimo elemento
+     */
+    const_iterator end() const{
+        const char *e = _payload == nullptr ? nullptr : _payload + _header.payload_bytes;
+        return const_iterator(e, e);
+    }
+    /**
+     * @brief Operatore di stream
+     * @param os stream di output
+     * @param s set da spedire sullo stream
+     * @return reference dello stream di output
+     */
+    friend std::ostream& operator<<(std::ostream &os, const MappedSet &s){
+        for (const_iterator b = s.begin(), e = s.end(); b != e; ++b)
+            os<<*b<<" ";
+        return os;
+    }
+};
+
+#endif
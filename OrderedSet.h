@@ -0,0 +1,703 @@
+#ifndef ORDERED_SET_H
+#define ORDERED_SET_H
+#include <functional> // std::less
+#include <iterator> // std::bidirectional_iterator_tag
+#include <memory> // std::allocator
+#include <new>
+#include <ostream>
+#include <utility> // std::move, std::swap
+#include "node_pool.h"
+/**
+ * @brief Classe OrderedSet
+ *
+ * Set ordinato secondo il comparatore Less: due valori sono considerati
+ * uguali se nessuno dei due precede l'altro. Gli elementi sono salvati in un
+ * albero AVL (bilanciato in altezza) i cui nodi provengono da un node_pool,
+ * quindi contains, add e remove costano O(log n) e l'iterazione visita gli
+ * elementi in ordine crescente. lower_bound, upper_bound e range permettono
+ * di visitare un intervallo di valori senza scandire tutto il set
+ *
+ * @tparam T tipo degli elementi
+ * @tparam Less funtore di ordinamento stretto tra due valori di tipo T
+ * @tparam Alloc allocatore compatibile con std::allocator usato per i nodi
+ */
+template<typename T, typename Less = std::less<T>, typename Alloc = std::allocator<T> > class OrderedSet{
+    /**
+     * @brief Struttura nodo dell'albero
+     */
+    struct nodo{
+        T value;///< valore memorizzato
+        nodo *left;///< sottoalbero dei valori minori
+        nodo *right;///< sottoalbero dei valori maggiori
+        nodo *parent;///< nodo padre, nullptr per la radice
+        int height;///< altezza del sottoalbero radicato nel nodo
+
+        /**
+         * @brief Costruttore secondario
+         *
+         * @param val valore da memorizzare
+         * @post height == 1
+         */
+        explicit nodo(const T &val) : value(val), left(nullptr), right(nullptr), parent(nullptr), height(1) {}
+    };
+
+    nodo *_root;///< radice dell'albero
+    unsigned int _size;///< numero di elementi salvati
+    Less _less;///< funtore di ordinamento tra due valori di tipo T
+    node_pool<nodo, Alloc> _pool;///< arena da cui provengono i nodi
+
+    /**
+     * @brief Alloca e costruisce un nodo
+     *
+     * @param value valore da memorizzare
+     * @return puntatore al nodo
+     * @throw std::bad_alloc possibile eccezione di allocazione
+     */
+    nodo* create_node(const T &value){
+        void *p = _pool.allocate();
+        try{
+            return new(p) nodo(value);
+        }catch(...){
+            _pool.deallocate(p);
+            throw;
+        }
+    }
+    /**
+     * @brief Distrugge un nodo e ne rende riutilizzabile la memoria
+     *
+     * @param n nodo da distruggere
+     */
+    void destroy_node(nodo *n){
+        n->~nodo();
+        _pool.deallocate(n);
+    }
+    /**
+     * @brief Distrugge tutti i nodi di un sottoalbero
+     *
+     * @param n radice del sottoalbero
+     */
+    void destroy_tree(nodo *n){
+        while (n != nullptr){
+            destroy_tree(n->right);
+            nodo *left = n->left;
+            destroy_node(n);
+            n = left;
+        }
+    }
+    /**
+     * @brief Copia un sottoalbero mantenendone la forma
+     *
+     * @param n radice del sottoalbero da copiare
+     * @param parent padre della copia
+     * @return radice della copia
+     * @throw std::bad_alloc possibile eccezione di allocazione, in tal caso la copia parziale viene distrutta
+     */
+    nodo* clone(const nodo *n, nodo *parent){
+        if (n == nullptr)
+            return nullptr;
+        nodo *copy = create_node(n->value);
+        copy->height = n->height;
+        copy->parent = parent;
+        try{
+            copy->left = clone(n->left, copy);
+            copy->right = clone(n->right, copy);
+        }catch(...){
+            destroy_tree(copy);
+            throw;
+        }
+        return copy;
+    }
+    /**
+     * @brief Verifica che due valori siano equivalenti secondo Less
+     */
+    bool equivalent(const T &a, const T &b) const{
+        return !_less(a, b) && !_less(b, a);
+    }
+    /**
+     * @brief Nodo con il valore più piccolo di un sottoalbero
+     */
+    static nodo* leftmost(nodo *n){
+        while (n->left != nullptr)
+            n = n->left;
+        return n;
+    }
+    /**
+     * @brief Nodo con il valore più grande di un sottoalbero
+     */
+    static nodo* rightmost(nodo *n){
+        while (n->right != nullptr)
+            n = n->right;
+        return n;
+    }
+    /**
+     * @brief Altezza di un sottoalbero, 0 se vuoto
+     */
+    static int height(const nodo *n){
+        return n == nullptr ? 0 : n->height;
+    }
+    /**
+     * @brief Ricalcola l'altezza di un nodo dalle altezze dei figli
+     */
+    static void update(nodo *n){
+        int l = height(n->left), r = height(n->right);
+        n->height = 1 + (l > r ? l : r);
+    }
+    /**
+     * @brief Sostituisce il figlio old di parent con replacement
+     *
+     * @param parent padre di old, nullptr se old è la radice
+     * @param old figlio da sostituire
+     * @param replacement nuovo figlio, può essere nullptr
+     */
+    void replace_child(nodo *parent, nodo *old, nodo *replacement){
+        if (parent == nullptr)
+            _root = replacement;
+        else if (parent->left == old)
+            parent->left = replacement;
+        else
+            parent->right = replacement;
+        if (replacement != nullptr)
+            replacement->parent = parent;
+    }
+    /**
+     * @brief Rotazione a sinistra attorno a x
+     *
+     * @return nuova radice del sottoalbero
+     */
+    nodo* rotate_left(nodo *x){
+        nodo *y = x->right;
+        replace_child(x->parent, x, y);
+        x->right = y->left;
+        if (y->left != nullptr)
+            y->left->parent = x;
+        y->left = x;
+        x->parent = y;
+        update(x);
+        update(y);
+        return y;
+    }
+    /**
+     * @brief Rotazione a destra attorno a x
+     *
+     * @return nuova radice del sottoalbero
+     */
+    nodo* rotate_right(nodo *x){
+        nodo *y = x->left;
+        replace_child(x->parent, x, y);
+        x->left = y->right;
+        if (y->right != nullptr)
+            y->right->parent = x;
+        y->right = x;
+        x->parent = y;
+        update(x);
+        update(y);
+        return y;
+    }
+    /**
+     * @brief Aggiorna altezze e ribilancia risalendo da n fino alla radice
+     *
+     * @param n primo nodo da controllare
+     */
+    void rebalance(nodo *n){
+        while (n != nullptr){
+            update(n);
+            int balance = height(n->left) - height(n->right);
+            if (balance > 1){
+                if (height(n->left->left) < height(n->left->right))
+                    rotate_left(n->left);
+                n = rotate_right(n);
+            }else if (balance < -1){
+                if (height(n->right->right) < height(n->right->left))
+                    rotate_right(n->right);
+                n = rotate_left(n);
+            }
+            n = n->parent;
+        }
+    }
+    /**
+     * @brief Nodo con valore equivalente a value
+     *
+     * @param value valore da cercare
+     * @return puntatore al nodo, nullptr se il valore non è presente
+     */
+    nodo* find_node(const T &value) const{
+        nodo *current = _root;
+        while (current != nullptr){
+            if (_less(value, current->value))
+                current = current->left;
+            else if (_less(current->value, value))
+                current = current->right;
+            else
+                return current;
+        }
+        return nullptr;
+    }
+    /**
+     * @brief Scollega dall'albero un nodo e lo distrugge
+     *
+     * Se il nodo ha due figli viene sostituito dal suo successore,
+     * ricollegando i nodi senza copiare valori
+     *
+     * @param z nodo da rimuovere
+     */
+    void erase_node(nodo *z){
+        nodo *start;
+        if (z->left == nullptr || z->right == nullptr){
+            start = z->parent;
+            replace_child(z->parent, z, z->left != nullptr ? z->left : z->right);
+        }else{
+            nodo *y = leftmost(z->right);
+            if (y->parent != z){
+                start = y->parent;
+                replace_child(y->parent, y, y->right);
+                y->right = z->right;
+                y->right->parent = y;
+            }else
+                start = y;
+            replace_child(z->parent, z, y);
+            y->left = z->left;
+            y->left->parent = y;
+            y->height = z->height;
+        }
+        rebalance(start);
+        destroy_node(z);
+        _size--;
+    }
+
+public:
+    class const_iterator;
+
+    /**
+     * @brief Costruttore di default
+     *
+     * @post _root == nullptr
+     * @post _size == 0
+     */
+    OrderedSet() : _root(nullptr), _size(0), _pool() {}
+
+    /**
+     * @brief Costruttore con comparatore e allocatore
+     *
+     * @param less funtore di ordinamento
+     * @param alloc allocatore da cui prendere la memoria dei nodi
+     */
+    explicit OrderedSet(const Less &less, const Alloc &alloc = Alloc()) : _root(nullptr), _size(0), _less(less), _pool(alloc) {}
+
+    /**
+     * @brief Copy constructor, copia l'albero mantenendone la forma in O(n)
+     *
+     * @param other set da copiare
+     * @throw std::bad_alloc possibile eccezione di allocazione
+     */
+    OrderedSet(const OrderedSet &other) : _root(nullptr), _size(0), _less(other._less),
+        _pool(std::allocator_traits<Alloc>::select_on_container_copy_construction(other._pool.get_allocator())){
+        _root = clone(other._root, nullptr);
+        _size = other._size;
+    }
+    /**
+     * @brief Move constructor, si appropria dei nodi di other in O(1)
+     *
+     * @param other set da cui spostare i dati
+     * @post other.isEmpty()
+     */
+    OrderedSet(OrderedSet &&other) noexcept : _root(other._root), _size(other._size), _less(other._less), _pool(std::move(other._pool)){
+        other._root = nullptr;
+        other._size = 0;
+    }
+    /**
+     * @brief Operatore assegnamento
+     *
+     * @param other set da copiare
+     * @return reference al set this
+     */
+    OrderedSet& operator=(const OrderedSet &other){
+        if (this != &other){
+            OrderedSet tmp(other);
+            swap(tmp);
+        }
+        return *this;
+    }
+    /**
+     * @brief Operatore assegnamento per spostamento
+     *
+     * @param other set da cui spostare i dati
+     * @return reference al set this
+     * @post other.isEmpty()
+     */
+    OrderedSet& operator=(OrderedSet &&other) noexcept{
+        if (this != &other){
+            clear();
+            swap(other);
+        }
+        return *this;
+    }
+    /**
+     * @brief Distruttore
+     */
+    ~OrderedSet(){
+        clear();
+    }
+    /**
+     * @brief Costruttore secondario, costruisce un set a partire da due iteratori sul tipo Q
+     *
+     * @tparam Q tipo dell'iteratore
+     * @param b iteratore di inizio
+     * @param e iteratore di fine
+     * @throw std::bad_alloc possibile eccezione di allocazione
+     */
+    template<typename Q> OrderedSet(Q b, Q e) : _root(nullptr), _size(0), _pool(){
+        try{
+            for(; b!=e; ++b)
+                add(static_cast<T>(*b));
+        }catch(...){
+            clear();
+            throw;
+        }
+    }
+    /**
+     * @brief Scambia il contenuto con un altro set
+     *
+     * @param other set con cui fare lo scambio
+     */
+    void swap(OrderedSet &other){
+        std::swap(_root, other._root);
+        std::swap(_size, other._size);
+        std::swap(_less, other._less);
+        _pool.swap(other._pool);
+    }
+    /**
+     * @brief Aggiunge un valore solo se non è presente, in O(log n)
+     *
+     * @param value valore da memorizzare
+     * @throw std::bad_alloc possibile eccezione di allocazione, in tal caso il set non viene alterato
+     */
+    void add(const T &value){
+        nodo *parent = nullptr;
+        nodo *current = _root;
+        bool go_left = false;
+        while (current != nullptr){
+            parent = current;
+            if (_less(value, current->value))
+                go_left = true;
+            else if (_less(current->value, value))
+                go_left = false;
+            else
+                return;
+            current = go_left ? current->left : current->right;
+        }
+        nodo *aus = create_node(value);
+        aus->parent = parent;
+        if (parent == nullptr)
+            _root = aus;
+        else if (go_left)
+            parent->left = aus;
+        else
+            parent->right = aus;
+        _size++;
+        rebalance(parent);
+    }
+    /**
+     * @brief Rimuove il valore passato solo se è presente, in O(log n)
+     *
+     * @param value valore da rimuovere
+     */
+    void remove(const T &value){
+        nodo *n = find_node(value);
+        if (n != nullptr)
+            erase_node(n);
+    }
+    /**
+     * @brief Svuota il set
+     *
+     * @post _root == nullptr
+     * @post _size == 0
+     */
+    void clear(){
+        destroy_tree(_root);
+        _pool.release();
+        _root = nullptr;
+        _size = 0;
+    }
+    /**
+     * @brief Numero degli elementi salvati
+     *
+     * @return numero di elementi
+     */
+    unsigned int size() const{
+        return _size;
+    }
+    /**
+     * @brief Verifica che il set sia vuoto
+     *
+     * @return true se il set è vuoto
+     */
+    bool isEmpty() const{
+        return _size == 0;
+    }
+    /**
+     * @brief Verifica se il valore passato è contenuto nel set, in O(log n)
+     *
+     * @param value valore da cercare
+     * @return true se il valore è presente
+     * @return false se il valore non è presente
+     */
+    bool contains(const T &value) const{
+        return find_node(value) != nullptr;
+    }
+    /**
+     * @brief Allocatore usato dal set
+     *
+     * @return copia dell'allocatore
+     */
+    Alloc get_allocator() const{
+        return _pool.get_allocator();
+    }
+
+    /**
+     * @brief Iteratore costante bidirezionale, visita gli elementi in ordine crescente
+     */
+    class const_iterator{
+        public:
+            typedef std::bidirectional_iterator_tag iterator_category;
+            typedef T                               value_type;
+            typedef ptrdiff_t                       difference_type;
+            typedef const T*                        pointer;
+            typedef const T&                        reference;
+
+            /**
+             * @brief Costruttore di default
+             *
+             */
+            const_iterator() : _set(nullptr), ptr(nullptr) {}
+
+            /**
+             * @brief Operatore*
+             *
+             * @return reference al dato riferito dall'iteratore (dereferenziamento)
+             */
+            reference operator*() const{
+                return ptr->value;
+            }
+            /**
+             * @brief Operatore->
+             *
+             * @return puntatore al dato riferito dall'iteratore
+             */
+            pointer operator->() const{
+                return &(ptr->value);
+            }
+            /**
+             * @brief Operatore++ pre-incremento, passa al successore
+             * @return reference all'iteratore this
+             */
+            const_iterator& operator++(){
+                if (ptr->right != nullptr)
+                    ptr = leftmost(ptr->right);
+                else{
+                    const nodo *child = ptr;
+                    ptr = ptr->parent;
+                    while (ptr != nullptr && ptr->right == child){
+                        child = ptr;
+                        ptr = ptr->parent;
+                    }
+                }
+                return *this;
+            }
+            /**
+             * @brief Operatore++ di post-incremento
+             * @return copia dell'iteratore che punta al valore precedente
+             */
+            const_iterator operator++(int){
+                const_iterator tmp(*this);
+                ++*this;
+                return tmp;
+            }
+            /**
+             * @brief Operatore-- pre-decremento, passa al predecessore (da end() all'ultimo elemento)
+             * @return reference all'iteratore this
+             */
+            const_iterator& operator--(){
+                if (ptr == nullptr)
+                    ptr = rightmost(_set->_root);
+                else if (ptr->left != nullptr)
+                    ptr = rightmost(ptr->left);
+                else{
+                    const nodo *child = ptr;
+                    ptr = ptr->parent;
+                    while (ptr != nullptr && ptr->left == child){
+                        child = ptr;
+                        ptr = ptr->parent;
+                    }
+                }
+                return *this;
+            }
+            /**
+             * @brief Operatore-- di post-decremento
+             * @return copia dell'iteratore che punta al valore successivo
+             */
+            const_iterator operator--(int){
+                const_iterator tmp(*this);
+                --*this;
+                return tmp;
+            }
+            /**
+             * @brief Operatore==
+             *
+             * @param other iteratore da confrontare
+             * @return true se i due iteratori puntano allo stesso nodo
+             */
+            bool operator==(const const_iterator &other) const{
+                return ptr == other.ptr;
+            }
+            /**
+             * @brief Operatore!=
+             *
+             * @param other iteratore da confrontare
+             * @return true se i due iteratori puntano a nodi diversi
+             */
+            bool operator!=(const const_iterator &other) const{
+                return ptr != other.ptr;
+            }
+
+        private:
+            friend class OrderedSet;
+
+            const OrderedSet *_set;///< set visitato, usato da operator-- su end()
+            nodo *ptr;///< nodo corrente, nullptr per end()
+
+            const_iterator(const OrderedSet *set, nodo *p) : _set(set), ptr(p) {}
+    };
+
+    /**
+     * @brief Intervallo [begin, end) di elementi, utilizzabile in un range-for
+     */
+    class range_view{
+        const_iterator _begin;///< primo elemento dell'intervallo
+        const_iterator _end;///< elemento successivo all'ultimo
+
+    public:
+        /**
+         * @brief Costruttore
+         *
+         * @param b primo elemento
+         * @param e elemento successivo all'ultimo
+         */
+        range_view(const_iterator b, const_iterator e) : _begin(b), _end(e) {}
+        /**
+         * @brief Iteratore di inizio dell'intervallo
+         */
+        const_iterator begin() const{
+            return _begin;
+        }
+        /**
+         * @brief Iteratore di fine dell'intervallo
+         */
+        const_iterator end() const{
+            return _end;
+        }
+    };
+
+    /**
+     * @brief Iteratore al più piccolo elemento
+     *
+     * @return iteratore di inizio
+     */
+    const_iterator begin() const{
+        return const_iterator(this, _root == nullptr ? nullptr : leftmost(_root));
+    }
+    /**
+     * @brief Iteratore di fine
+     *
+     * @return iteratore successivo al più grande elemento
+     */
+    const_iterator end() const{
+        return const_iterator(this, nullptr);
+    }
+    /**
+     * @brief Primo elemento non minore di value, in O(log n)
+     *
+     * @param value valore di riferimento
+     * @return iteratore all'elemento, end() se tutti gli elementi sono minori
+     */
+    const_iterator lower_bound(const T &value) const{
+        nodo *current = _root, *result = nullptr;
+        while (current != nullptr){
+            if (_less(current->value, value))
+                current = current->right;
+            else{
+                result = current;
+                current = current->left;
+            }
+        }
+        return const_iterator(this, result);
+    }
+    /**
+     * @brief Primo elemento maggiore di value, in O(log n)
+     *
+     * @param value valore di riferimento
+     * @return iteratore all'elemento, end() se nessun elemento è maggiore
+     */
+    const_iterator upper_bound(const T &value) const{
+        nodo *current = _root, *result = nullptr;
+        while (current != nullptr){
+            if (_less(value, current->value)){
+                result = current;
+                current = current->left;
+            }else
+                current = current->right;
+        }
+        return const_iterator(this, result);
+    }
+    /**
+     * @brief Elementi compresi nell'intervallo semiaperto [lo, hi)
+     *
+     * La ricerca degli estremi costa O(log n), la visita O(k) per k elementi
+     *
+     * @param lo estremo inferiore, incluso
+     * @param hi estremo superiore, escluso
+     * @return intervallo iterabile, vuoto se hi non è maggiore di lo
+     */
+    range_view range(const T &lo, const T &hi) const{
+        if (!_less(lo, hi))
+            return range_view(end(), end());
+        return range_view(lower_bound(lo), lower_bound(hi));
+    }
+    /**
+     * @brief Operatore == che verifica che due set contengono gli stessi elementi
+     *
+     * Entrambi sono ordinati: basta un confronto in parallelo, O(n)
+     *
+     * @param other set da confrontare
+     * @return true se i set sono uguali
+     */
+    bool operator==(const OrderedSet &other) const{
+        if (_size != other._size)
+            return false;
+        for (const_iterator a = begin(), b = other.begin(); a != end(); ++a, ++b)
+            if (!equivalent(*a, *b))
+                return false;
+        return true;
+    }
+    /**
+     * @brief Operatore !=
+     *
+     * @param other set da confrontare
+     * @return true se i set sono diversi
+     */
+    bool operator!=(const OrderedSet &other) const{
+        return !(*this == other);
+    }
+    /**
+     * @brief Operatore di stream, stampa gli elementi in ordine crescente
+     * @param os stream di output
+     * @param s set da spedire sullo stream
+     * @return reference dello stream di output
+     */
+    friend std::ostream& operator<<(std::ostream &os, const OrderedSet &s){
+        for (const_iterator b = s.begin(), e = s.end(); b != e; ++b)
+            os<<*b<<" ";
+        return os;
+    }
+};
+
+#endif
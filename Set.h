@@ -5,28 +5,105 @@
 #include <ostream>
 #include <cassert>
 #include <iterator> // std::forward_iterator_tag
-#include <cstddef> // std::ptrdiff_t
+#include <cstddef> // std::ptrdiff_t, std::size_t
+#include <type_traits> // std::is_same, std::is_trivially_destructible
+#include <utility> // std::move, std::forward
+#include <memory> // std::allocator, std::allocator_traits
+#include <new> // placement new
+#include <vector>
+#include <atomic>
+#include <mutex>
+#include <stdexcept> // std::invalid_argument
 #include "set_index_out_of_bound.h"
+#include "node_pool.h"
+#include "execution_policy.h"
+#include "set_stats.h"
+/**
+ * @brief Funtore hash nullo
+ * 
+ * Usato come valore di default del parametro Hash di Set: indica che il set
+ * non mantiene un indice hash e che le ricerche avvengono scorrendo la lista
+ */
+struct no_hash{
+    typedef void is_transparent;///< accetta qualunque tipo: non ostacola la ricerca eterogenea
+
+    template<typename U>
+    std::size_t operator()(const U &) const{
+        return 0;
+    }
+};
+/**
+ * @brief Funtore hash di un Set
+ * 
+ * Restituisce l'impronta del contenuto: permette di indicizzare set di set
+ * indicizzati, es. Set<Set<T, Eql, Hash>, equals_set, set_hash>
+ */
+struct set_hash{
+    template<typename S>
+    std::size_t operator()(const S &s) const{
+        return s.fingerprint();
+    }
+};
+/**
+ * @brief Vero se il funtore F dichiara il tipo F::is_transparent
+ * 
+ * Come per i contenitori standard, un funtore trasparente si impegna ad 
+ * accettare, oltre a T, anche altri tipi di chiave confrontabili con T
+ */
+template<typename F, typename = void> struct is_transparent_functor : std::false_type {};
+template<typename F> struct is_transparent_functor<F, std::void_t<typename F::is_transparent> > : std::true_type {};
+template<typename S> struct set_ops;
 /**
  * @brief Classe Set
  * 
  * La classe implementa un generico set in cui ogni elemento compare
  * una e una sola volta
  * 
- * @tparam T 
+ * Se viene fornito un funtore Hash diverso da no_hash, il set affianca alla lista
+ * una tabella hash a indirizzamento aperto (scansione lineare) che punta ai nodi: 
+ * add, remove e contains diventano O(1) ammortizzato, mentre l'iterazione
+ * resta nell'ordine di inserimento
+ * 
+ * I nodi non vengono allocati singolarmente: provengono da un node_pool che 
+ * chiede memoria all'allocatore a blocchi e ricicla i nodi rimossi; clear()
+ * restituisce tutti i blocchi in una volta
+ * 
+ * Con N > 0 i primi N nodi sono contenuti nell'oggetto Set stesso (vedi
+ * node_pool): un set con al più N elementi non alloca nodi. In cambio lo
+ * spostamento e l'unione con operator+=(Set&&) copiano o spostano i valori
+ * uno alla volta, perché i nodi inline non possono cambiare proprietario
+ * 
+ * Se Eql e Hash dichiarano is_transparent, contains, remove e find accettano
+ * anche chiavi di tipo K diverso da T (es. std::string_view per T = std::string)
+ * senza costruire un T temporaneo: Eql deve accettare (T, K) e Hash deve dare
+ * a una chiave lo stesso hash dell'elemento uguale
+ * 
+ * @tparam T tipo degli elementi
+ * @tparam Eql funtore di uguaglianza tra due valori di tipo T
+ * @tparam Hash funtore hash su T, coerente con Eql (default no_hash: nessun indice)
+ * @tparam Alloc allocatore compatibile con std::allocator usato per nodi e tabella
+ * @tparam N numero di nodi contenuti nel set (default 0: tutti dall'allocatore)
  */
-template<typename T, typename Eql> class Set{
+template<typename T, typename Eql, typename Hash = no_hash, typename Alloc = std::allocator<T>, unsigned int N = 0> class Set{
+    /**
+     * @brief Tag che seleziona il costruttore "in place" di nodo
+     */
+    struct emplace_tag{};
+    static const unsigned int no_rank = ~0u;///< rank di un nodo mai entrato nella cache di operator[]
     /**
      * @brief Struttura nodo
      */
     struct nodo{
         T value;///< valore memorizzato
+        unsigned int rank;///< posizione nella cache di operator[], valida solo se la cache contiene il nodo in quella posizione (4 byte per nodo, nel padding se T è int)
         nodo *next;///< puntatore al nodo successivo della lista
+        nodo *prev;///< puntatore al nodo precedente della lista
         /**
          * Costuttore di default
          * @post next == nullptr
+         * @post prev == nullptr
          */
-        nodo() : next(nullptr) {}
+        nodo() : rank(no_rank), next(nullptr), prev(nullptr) {}
         /**
          * @brief Costruttore secondario
          * 
@@ -35,8 +112,9 @@ template<typename T, typename Eql> class Set{
          * 
          * @post value == val
          * @post next == n
+         * @post prev == nullptr
          */
-        nodo(const T &val, nodo *n) : value(val), next(n) {}
+        nodo(const T &val, nodo *n) : value(val), rank(no_rank), next(n), prev(nullptr) {}
 
         /**
          * @brief Costruttore secondario
@@ -45,8 +123,30 @@ template<typename T, typename Eql> class Set{
          * 
          * @post value == val
          * @post next == nullptr
+         * @post prev == nullptr
          */
-        explicit nodo(const T &val) : value(val), next(nullptr) {}
+        explicit nodo(const T &val) : value(val), rank(no_rank), next(nullptr), prev(nullptr) {}
+
+        /**
+         * @brief Costruttore secondario, sposta il valore nel nodo
+         * 
+         * @param val valore da spostare
+         * 
+         * @post next == nullptr
+         * @post prev == nullptr
+         */
+        explicit nodo(T &&val) : value(std::move(val)), rank(no_rank), next(nullptr), prev(nullptr) {}
+
+        /**
+         * @brief Costruttore secondario, costruisce il valore direttamente nel nodo
+         * 
+         * @param args argomenti del costruttore di T
+         * 
+         * @post next == nullptr
+         * @post prev == nullptr
+         */
+        template<typename... Args>
+        nodo(emplace_tag, Args&&... args) : value(std::forward<Args>(args)...), rank(no_rank), next(nullptr), prev(nullptr) {}
 
         /**
          * Copy constructor
@@ -54,10 +154,11 @@ template<typename T, typename Eql> class Set{
          * 
          * @param other oggetto nodo da copiare
          */
-        nodo(const nodo &other){
+        nodo(const nodo &other) : rank(no_rank){
             if (this != &other){
                 value = other.value;
                 next = other.next;
+                prev = other.prev;
             }
         }
         /**
@@ -70,6 +171,7 @@ template<typename T, typename Eql> class Set{
         nodo& operator=(const nodo &other){
             value = other.value;
             next = other.next;
+            prev = other.prev;
             return *this;
         }
         /**
@@ -90,8 +192,639 @@ template<typename T, typename Eql> class Set{
     };
 
     nodo *_head;///< puntatore al primo nodo della lista
+    nodo *_tail;///< puntatore all'ultimo nodo della lista
     unsigned int _size;///< numero di elementi salvati
     Eql _equals;///< funtore di uguaglianza tra due valori di tipo T
+    Hash _hash;///< funtore hash sui valori di tipo T
+    nodo **_table;///< tabella hash a indirizzamento aperto (nullptr se non indicizzato)
+    unsigned int _capacity;///< numero di slot della tabella (potenza di 2)
+    unsigned int _occupied;///< numero di slot occupati da nodi o da lapidi
+    std::size_t _fingerprint;///< somma delle impronte degli elementi (solo se indicizzato)
+    node_pool<nodo, Alloc, N> _pool;///< arena da cui provengono i nodi
+
+    typedef typename std::allocator_traits<Alloc>::template rebind_alloc<nodo*> table_allocator;
+    typedef std::allocator_traits<table_allocator> table_traits;
+
+    /**
+     * @brief Cache delle posizioni usata da operator[], allocata al primo accesso
+     */
+    struct position_cache{
+        std::mutex mutex;///< serializza le estensioni della cache tra lettori concorrenti
+        std::vector<nodo*, table_allocator> nodes;///< prefisso della lista in ordine di inserimento
+
+        explicit position_cache(const table_allocator &alloc) : nodes(alloc) {}
+    };
+    typedef typename std::allocator_traits<Alloc>::template rebind_alloc<position_cache> cache_allocator;
+    typedef std::allocator_traits<cache_allocator> cache_traits;
+
+    mutable std::atomic<position_cache*> _positions{nullptr};///< cache di operator[], nullptr finché non serve
+    SET_STAT(mutable set_stats _stats;)///< contatori, presenti solo con SET_INSTRUMENTATION
+
+    static const bool _indexed = !std::is_same<Hash, no_hash>::value;///< true se il set mantiene l'indice hash
+    static const unsigned int _min_capacity = 16;///< dimensione minima della tabella
+
+    /**
+     * @brief R se K è una chiave di ricerca eterogenea ammessa (Eql e Hash trasparenti, K diverso da T)
+     */
+    template<typename K, typename R>
+    using if_key = typename std::enable_if<is_transparent_functor<Eql>::value && is_transparent_functor<Hash>::value
+                                           && !std::is_same<K, T>::value, R>::type;
+    /**
+     * @brief R se K è T oppure una chiave di ricerca eterogenea ammessa
+     */
+    template<typename K, typename R>
+    using if_value_or_key = typename std::enable_if<std::is_same<K, T>::value
+                                                    || (is_transparent_functor<Eql>::value && is_transparent_functor<Hash>::value), R>::type;
+
+    /**
+     * @brief Marcatore degli slot liberati da remove
+     * 
+     * Una lapide non interrompe la scansione lineare durante la ricerca,
+     * ma può essere riutilizzata dall'inserimento
+     * 
+     * @return puntatore sentinella, mai dereferenziato
+     */
+    static nodo* tombstone(){
+        static char marker;
+        return reinterpret_cast<nodo*>(&marker);
+    }
+    /**
+     * @brief Slot di partenza della scansione per un valore
+     * 
+     * Il valore del funtore hash viene rimescolato (moltiplicazione di Fibonacci)
+     * in modo che anche hash banali come std::hash<int> distribuiscano bene sui bit bassi
+     * 
+     * @tparam K tipo del valore, T o una chiave eterogenea
+     * @param value valore di cui calcolare lo slot
+     * @return indice nella tabella
+     */
+    template<typename K>
+    unsigned int slot_of(const K &value) const{
+        unsigned long long h = static_cast<unsigned long long>(_hash(value));
+        h *= 0x9E3779B97F4A7C15ULL;
+        return static_cast<unsigned int>(h >> 32) & (_capacity - 1);
+    }
+    /**
+     * @brief Impronta di un singolo valore
+     * 
+     * L'hash viene rimescolato con il finalizzatore di splitmix64: la somma delle
+     * impronte non dipende dall'ordine degli elementi, ma a differenza della 
+     * somma degli hash grezzi non collide per insiemi come {1,4} e {2,3}
+     * 
+     * @param value valore di cui calcolare l'impronta
+     * @return impronta del valore
+     */
+    std::size_t fingerprint_of(const T &value) const{
+        return static_cast<std::size_t>(mix_hash(_hash(value)));
+    }
+    /**
+     * @brief Finalizzatore di splitmix64: tutti i bit del risultato dipendono da tutti i bit di h
+     * 
+     * @param h hash grezzo
+     * @return hash rimescolato
+     */
+    static unsigned long long mix_hash(std::size_t h){
+        unsigned long long x = static_cast<unsigned long long>(h);
+        x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+        return x ^ (x >> 31);
+    }
+    /**
+     * @brief Cerca lo slot della tabella che contiene il nodo con il valore passato
+     * 
+     * @tparam K tipo del valore, T o una chiave eterogenea
+     * @param value valore da cercare
+     * @return indice dello slot, oppure _capacity se il valore non è presente
+     */
+    template<typename K>
+    unsigned int find_slot(const K &value) const{
+        if (_table == nullptr)
+            return _capacity;
+        unsigned int i = slot_of(value);
+        while (_table[i] != nullptr){
+            SET_STAT(_stats.nodes_traversed++;)
+            if (_table[i] != tombstone()){
+                SET_STAT(_stats.equality_comparisons++;)
+                if (_equals(_table[i]->value, value))
+                    return i;
+            }
+            i = (i + 1) & (_capacity - 1);
+        }
+        return _capacity;
+    }
+    /**
+     * @brief Inserisce nella tabella un nodo il cui valore non è già indicizzato
+     * 
+     * @param n nodo da indicizzare
+     * @pre la tabella ha almeno uno slot vuoto
+     */
+    void index_node(nodo *n){
+        unsigned int i = slot_of(n->value);
+        while (_table[i] != nullptr && _table[i] != tombstone())
+            i = (i + 1) & (_capacity - 1);
+        if (_table[i] == nullptr)
+            _occupied++;
+        _table[i] = n;
+    }
+    /**
+     * @brief Ricostruisce la tabella con la capacità indicata, eliminando le lapidi
+     * 
+     * @param capacity nuova capacità (potenza di 2, maggiore di _size)
+     * @throw std::bad_alloc possibile eccezione di allocazione, in tal caso il set non viene alterato
+     */
+    void rehash(unsigned int capacity){
+        table_allocator alloc(_pool.get_allocator());
+        nodo **table = table_traits::allocate(alloc, capacity);
+        SET_STAT(_stats.allocations++;)
+        std::fill(table, table + capacity, static_cast<nodo*>(nullptr));
+        free_table();
+        _table = table;
+        _capacity = capacity;
+        _occupied = 0;
+        for (nodo *current = _head; current != nullptr; current = current->next)
+            index_node(current);
+    }
+    /**
+     * @brief Restituisce la tabella all'allocatore
+     * @post _table == nullptr
+     */
+    void free_table(){
+        if (_table == nullptr)
+            return;
+        table_allocator alloc(_pool.get_allocator());
+        table_traits::deallocate(alloc, _table, _capacity);
+        SET_STAT(_stats.deallocations++;)
+        _table = nullptr;
+    }
+    /**
+     * @brief Costruisce un nodo nella memoria fornita dal pool
+     * 
+     * @param args argomenti del costruttore di nodo
+     * @return puntatore al nuovo nodo, non collegato
+     * @throw std::bad_alloc possibile eccezione di allocazione
+     */
+    template<typename... Args>
+    nodo* create_node(Args&&... args){
+        void *p = _pool.allocate();
+        SET_STAT(_stats.allocations++;)
+        try{
+            return new (p) nodo(std::forward<Args>(args)...);
+        }catch(...){
+            _pool.deallocate(p);
+            SET_STAT(_stats.deallocations++;)
+            throw;
+        }
+    }
+    /**
+     * @brief Distrugge un nodo e ne rende la memoria al pool
+     * 
+     * @param n nodo da distruggere
+     */
+    void destroy_node(nodo *n){
+        n->~nodo();
+        _pool.deallocate(n);
+        SET_STAT(_stats.deallocations++;)
+    }
+    /**
+     * @brief Garantisce che la tabella possa accogliere extra nuovi nodi
+     * mantenendo il fattore di carico (lapidi comprese) sotto 1/2
+     * 
+     * @param extra numero di nodi da accogliere
+     * @throw std::bad_alloc possibile eccezione di allocazione
+     */
+    void reserve_slot(unsigned int extra = 1){
+        if (_table != nullptr && (_occupied + extra) * 2 <= _capacity)
+            return;
+        unsigned int capacity = _min_capacity;
+        while (capacity < (_size + extra) * 4)
+            capacity *= 2;
+        rehash(capacity);
+    }
+    /**
+     * @brief Cerca il nodo che contiene il valore passato con una sola scansione
+     * (una sola sonda della tabella se il set è indicizzato)
+     * 
+     * @tparam K tipo del valore, T o una chiave eterogenea
+     * @param value valore da cercare
+     * @return puntatore al nodo, nullptr se il valore non è presente
+     */
+    template<typename K>
+    nodo* find_node(const K &value) const{
+        if (_indexed){
+            unsigned int i = find_slot(value);
+            return i == _capacity ? nullptr : _table[i];
+        }
+        nodo *current = _head;
+        while (current != nullptr){
+            SET_STAT(_stats.nodes_traversed++;)
+            SET_STAT(_stats.equality_comparisons++;)
+            if (_equals(current->value, value))
+                return current;
+            current = current->next;
+        }
+        return nullptr;
+    }
+    /**
+     * @brief Collega un nuovo nodo in coda alla lista in O(1) tramite _tail
+     * 
+     * @param n nodo da collegare
+     * @post _tail == n
+     */
+    void link_back(nodo *n){
+        n->prev = _tail;
+        n->next = nullptr;
+        if (_tail == nullptr)
+            _head = n;
+        else
+            _tail->next = n;
+        _tail = n;
+        _size++;
+        if (_indexed)
+            _fingerprint += fingerprint_of(n->value);
+    }
+    /**
+     * @brief Cache di operator[], creata al primo accesso
+     * 
+     * Più lettori possono arrivare insieme: vince la prima cache pubblicata,
+     * le altre vengono distrutte
+     * 
+     * @return reference alla cache
+     * @throw std::bad_alloc possibile eccezione di allocazione
+     */
+    position_cache& positions() const{
+        position_cache *cache = _positions.load(std::memory_order_acquire);
+        if (cache != nullptr)
+            return *cache;
+        cache_allocator alloc(_pool.get_allocator());
+        position_cache *created = cache_traits::allocate(alloc, 1);
+        new (created) position_cache(table_allocator(_pool.get_allocator()));
+        if (_positions.compare_exchange_strong(cache, created, std::memory_order_acq_rel, std::memory_order_acquire))
+            return *created;
+        created->~position_cache();
+        cache_traits::deallocate(alloc, created, 1);
+        return *cache;
+    }
+    /**
+     * @brief Tronca la cache di operator[] alla posizione di n, se n vi compare
+     * 
+     * Le posizioni precedenti a n restano valide, quelle successive scalano
+     * 
+     * @param n nodo che sta per essere rimosso
+     */
+    void forget_position(nodo *n){
+        position_cache *cache = _positions.load(std::memory_order_relaxed);
+        if (cache != nullptr && n->rank < cache->nodes.size() && cache->nodes[n->rank] == n)
+            cache->nodes.resize(n->rank);
+    }
+    /**
+     * @brief Svuota la cache di operator[] mantenendone la memoria
+     */
+    void clear_positions(){
+        position_cache *cache = _positions.load(std::memory_order_relaxed);
+        if (cache != nullptr)
+            cache->nodes.clear();
+    }
+    /**
+     * @brief Restituisce la cache di operator[] all'allocatore
+     */
+    void free_positions(){
+        position_cache *cache = _positions.exchange(nullptr, std::memory_order_relaxed);
+        if (cache == nullptr)
+            return;
+        cache_allocator alloc(_pool.get_allocator());
+        cache->~position_cache();
+        cache_traits::deallocate(alloc, cache, 1);
+    }
+    /**
+     * @brief Scollega un nodo dalla lista e lo dealloca
+     * 
+     * @param n nodo da rimuovere
+     */
+    void unlink(nodo *n){
+        forget_position(n);
+        if (n->prev == nullptr)
+            _head = n->next;
+        else
+            n->prev->next = n->next;
+        if (n->next == nullptr)
+            _tail = n->prev;
+        else
+            n->next->prev = n->prev;
+        if (_indexed)
+            _fingerprint -= fingerprint_of(n->value);
+        destroy_node(n);
+        _size--;
+    }
+    /**
+     * @brief Rimuove dalla lista (e dall'indice) un nodo del set
+     * 
+     * @param n nodo da rimuovere
+     */
+    void erase_node(nodo *n){
+        if (_indexed)
+            _table[find_slot(n->value)] = tombstone();
+        unlink(n);
+    }
+    /**
+     * @brief Rimuove il nodo uguale al valore passato, se presente, con una sola sonda
+     *
+     * @tparam K tipo del valore, T o una chiave eterogenea
+     * @param value valore da rimuovere
+     */
+    template<typename K>
+    void erase_key(const K &value){
+        if (_indexed){
+            unsigned int i = find_slot(value);
+            if (i != _capacity){
+                unlink(_table[i]);
+                _table[i] = tombstone();
+            }
+            return;
+        }
+        nodo *n = find_node(value);
+        if (n != nullptr)
+            unlink(n);
+    }
+    /**
+     * @brief Rimuove tutti i nodi successivi a last
+     * 
+     * Usata per annullare gli inserimenti parziali in caso di eccezione
+     * 
+     * @param last ultimo nodo da mantenere, nullptr per svuotare la lista
+     */
+    void truncate_after(nodo *last){
+        nodo *current = last == nullptr ? _head : last->next;
+        while (current != nullptr){
+            nodo *next_node = current->next;
+            erase_node(current);
+            current = next_node;
+        }
+    }
+    /**
+     * @brief Aggiunge in coda un valore che il chiamante sa non essere presente,
+     * senza la ricerca del duplicato
+     * 
+     * @param value valore da memorizzare (copiato o spostato)
+     * @pre !contains(value)
+     * @throw std::bad_alloc possibile eccezione di allocazione
+     */
+    template<typename V>
+    void append_unique(V &&value){
+        if (_indexed)
+            reserve_slot();
+        nodo *aus = create_node(std::forward<V>(value));
+        link_back(aus);
+        if (_indexed)
+            index_node(aus);
+    }
+    /**
+     * @brief Costruzione a blocchi da una sequenza ad accesso casuale di n valori
+     * 
+     * 1. i valori vengono convertiti in T;
+     * 2. in parallelo, ogni thread calcola l'hash di un blocco contiguo e distribuisce 
+     *    gli indici in partizioni secondo i bit alti dell'hash;
+     * 3. in parallelo, ogni thread elimina i duplicati di una partizione visitando 
+     *    gli indici in ordine crescente, quindi vince la prima occorrenza;
+     * 4. i valori superstiti vengono spostati nei nodi in un'unica passata.
+     * Il risultato è identico a quello di add ripetuto sugli stessi valori
+     * 
+     * @param b iteratore ad accesso casuale al primo valore
+     * @param n numero di valori
+     * @pre il set è vuoto e indicizzato
+     * @throw std::bad_alloc possibile eccezione di allocazione
+     */
+    template<typename Q>
+    void bulk_build(Q b, unsigned int n){
+        std::vector<T> values;
+        values.reserve(n);
+        for (unsigned int i = 0; i < n; ++i)
+            values.push_back(static_cast<T>(b[i]));
+
+        unsigned int workers = execution::worker_count(n);
+        unsigned int chunk = (n + workers - 1) / workers;
+        std::vector<unsigned long long> mixed(n);
+        std::vector<char> first(n, 0);
+        std::vector<std::vector<unsigned int> > buckets(workers * workers); //buckets[thread * workers + partizione]
+
+        execution::parallel_for(workers, [&](unsigned int w){
+            unsigned int end = std::min(n, (w + 1) * chunk);
+            for (unsigned int i = w * chunk; i < end; ++i){
+                mixed[i] = mix_hash(_hash(values[i]));
+                buckets[w * workers + static_cast<unsigned int>((mixed[i] >> 32) % workers)].push_back(i);
+            }
+        });
+        execution::parallel_for(workers, [&](unsigned int p){
+            std::size_t count = 0;
+            for (unsigned int w = 0; w < workers; ++w)
+                count += buckets[w * workers + p].size();
+            unsigned int capacity = _min_capacity;
+            while (capacity < count * 2)
+                capacity *= 2;
+            std::vector<unsigned int> table(capacity, 0); //indice+1 della prima occorrenza, 0 se vuoto
+            for (unsigned int w = 0; w < workers; ++w){
+                const std::vector<unsigned int> &bucket = buckets[w * workers + p];
+                for (unsigned int k = 0; k < bucket.size(); ++k){
+                    unsigned int i = bucket[k];
+                    unsigned int slot = static_cast<unsigned int>(mixed[i]) & (capacity - 1);
+                    bool duplicate = false;
+                    while (table[slot] != 0){
+                        if (_equals(values[table[slot] - 1], values[i])){
+                            duplicate = true;
+                            break;
+                        }
+                        slot = (slot + 1) & (capacity - 1);
+                    }
+                    if (!duplicate){
+                        table[slot] = i + 1;
+                        first[i] = 1;
+                    }
+                }
+            }
+        });
+
+        reserve_slot(std::count(first.begin(), first.end(), 1));
+        for (unsigned int i = 0; i < n; ++i)
+            if (first[i])
+                append_unique(std::move(values[i]));
+    }
+    /**
+     * @brief Inserisce i valori di una sequenza ad accesso casuale, a blocchi se il set è indicizzato
+     */
+    template<typename Q>
+    void build_from(Q b, Q e, std::random_access_iterator_tag){
+        if (_indexed && b != e){
+            bulk_build(b, static_cast<unsigned int>(e - b));
+            return;
+        }
+        for(; b!=e; ++b)
+            add(static_cast<T>(*b));
+    }
+    /**
+     * @brief Inserisce uno alla volta i valori di una sequenza
+     */
+    template<typename Q>
+    void build_from(Q b, Q e, std::input_iterator_tag){
+        for(; b!=e; ++b)
+            add(static_cast<T>(*b));
+    }
+    /**
+     * @brief Scambia il contenuto del set this con quello di other
+     * 
+     * @param other set con cui scambiare i dati
+     */
+    void swap_data(Set &other){
+        std::swap(_head, other._head);
+        std::swap(_tail, other._tail);
+        std::swap(_size, other._size);
+        std::swap(_table, other._table);
+        std::swap(_capacity, other._capacity);
+        std::swap(_occupied, other._occupied);
+        std::swap(_fingerprint, other._fingerprint);
+        _pool.swap(other._pool);
+        position_cache *positions = _positions.load(std::memory_order_relaxed);
+        _positions.store(other._positions.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        other._positions.store(positions, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Sposta in this, vuoto, i valori di other uno alla volta e svuota other
+     * 
+     * Sostituisce lo scambio dei nodi quando N > 0. In caso di eccezione
+     * entrambi i set vengono svuotati
+     * 
+     * @param other set da cui spostare i valori
+     * @pre isEmpty()
+     * @post other.isEmpty()
+     * @throw std::bad_alloc possibile eccezione di allocazione
+     */
+    void relocate_from(Set &other){
+        try{
+            if (_indexed && other._size > 0)
+                reserve_slot(other._size);
+            for (nodo *current = other._head; current != nullptr; current = current->next)
+                append_unique(std::move_if_noexcept(current->value));
+        }catch(...){
+            clear();
+            other.clear();
+            throw;
+        }
+        other.clear();
+    }
+    /**
+     * @brief Distrugge gli elementi conservando blocchi del pool e tabella per riusarli
+     * 
+     * @post isEmpty()
+     */
+    void destroy_elements(){
+        nodo *current = _head;
+        while (current != nullptr){
+            nodo *next_node = current->next;
+            destroy_node(current);
+            current = next_node;
+        }
+        clear_positions();
+        _head = nullptr;
+        _tail = nullptr;
+        _size = 0;
+        if (_table != nullptr)
+            std::fill(_table, _table + _capacity, static_cast<nodo*>(nullptr));
+        _occupied = 0;
+        _fingerprint = 0;
+    }
+    /**
+     * @brief this prende il contenuto di other scambiando i nodi (N == 0)
+     * 
+     * @post other.isEmpty()
+     */
+    void take(Set &other, std::true_type){
+        clear();
+        swap_data(other);
+    }
+    /**
+     * @brief this prende il contenuto di other spostando i valori (N > 0)
+     * 
+     * Nodi e tabella per i valori di other vengono riservati prima di distruggere
+     * gli elementi di this: se l'allocazione fallisce this non cambia. Lo
+     * spostamento che segue non alloca, quindi può lanciare solo la copia di T
+     * quando il suo costruttore di spostamento non è noexcept
+     * 
+     * @post other.isEmpty()
+     * @throw std::bad_alloc possibile eccezione di allocazione, this non viene alterato
+     */
+    void take(Set &other, std::false_type){
+        _pool.reserve(other._size);
+        if (_indexed && other._size > 0){
+            unsigned int capacity = _min_capacity;
+            while (capacity < other._size * 4)
+                capacity *= 2;
+            if (_capacity < capacity)
+                rehash(capacity);
+        }
+        destroy_elements();
+        relocate_from(other);
+    }
+    /**
+     * @brief Unione con i valori di other quando i nodi non possono essere adottati
+     */
+    void absorb(Set &other, std::false_type){
+        *this += static_cast<const Set&>(other);
+        other.clear();
+    }
+    /**
+     * @brief Unione che adotta i blocchi di other e ne ricollega i nodi (N == 0)
+     */
+    void absorb(Set &other, std::true_type){
+        if (!(_pool.get_allocator() == other._pool.get_allocator())){
+            absorb(other, std::false_type());
+            return;
+        }
+        if (_indexed)
+            reserve_slot(other._size);
+        nodo *current = other._head;
+        _pool.adopt(other._pool);
+        other.free_table();
+        other.clear_positions();
+        other._head = nullptr;
+        other._tail = nullptr;
+        other._size = 0;
+        other._capacity = 0;
+        other._occupied = 0;
+        other._fingerprint = 0;
+        while (current != nullptr){
+            nodo *next_node = current->next;
+            if (find_node(current->value) != nullptr){
+                destroy_node(current);
+            }else{
+                link_back(current);
+                if (_indexed)
+                    index_node(current);
+            }
+            current = next_node;
+        }
+    }
+    /**
+     * @brief Move constructor che si appropria dei nodi di other (N == 0)
+     */
+    Set(Set &&other, std::true_type) noexcept : _head(other._head), _tail(other._tail), _size(other._size),
+        _table(other._table), _capacity(other._capacity), _occupied(other._occupied),
+        _fingerprint(other._fingerprint), _pool(std::move(other._pool)), _positions(other._positions.exchange(nullptr, std::memory_order_relaxed)){
+        other._head = nullptr;
+        other._tail = nullptr;
+        other._size = 0;
+        other._table = nullptr;
+        other._capacity = 0;
+        other._occupied = 0;
+        other._fingerprint = 0;
+    }
+    /**
+     * @brief Move constructor che sposta i valori di other uno alla volta (N > 0)
+     */
+    Set(Set &&other, std::false_type) : _head(nullptr), _tail(nullptr), _size(0), _table(nullptr), _capacity(0), _occupied(0), _fingerprint(0),
+        _pool(other._pool.get_allocator()){
+        relocate_from(other);
+    }
+
+    template<typename S> friend struct set_ops;///< algoritmi sugli insiemi, usano append_unique
 
 public:
     /**
@@ -101,7 +834,16 @@ public:
      * @post _size == 0
      * 
      */
-    Set() : _head(nullptr), _size(0) {}
+    Set() : _head(nullptr), _tail(nullptr), _size(0), _table(nullptr), _capacity(0), _occupied(0), _fingerprint(0), _pool() {}
+
+    /**
+     * @brief Costruttore con allocatore
+     * 
+     * @param alloc allocatore da cui prendere la memoria di nodi e tabella
+     * @post _head == nullptr
+     * @post _size == 0
+     */
+    explicit Set(const Alloc &alloc) : _head(nullptr), _tail(nullptr), _size(0), _table(nullptr), _capacity(0), _occupied(0), _fingerprint(0), _pool(alloc) {}
 
     /**
      * @brief Copy construtor
@@ -113,11 +855,14 @@ public:
      * @throw set_index_out_of_bound eccezzione indici fuori range
      * @throw std::bad_alloc eccezione durante l'allocazione di un nodo
      */
-    Set(const Set &other) : _head(nullptr), _size(0){
+    Set(const Set &other) : _head(nullptr), _tail(nullptr), _size(0), _table(nullptr), _capacity(0), _occupied(0), _fingerprint(0),
+        _pool(std::allocator_traits<Alloc>::select_on_container_copy_construction(other._pool.get_allocator())){
         nodo *current = other._head;
         try{
+            if (_indexed && other._size > 0)
+                reserve_slot(other._size);
             while (current != nullptr){
-                add(current->value);
+                append_unique(current->value); //gli elementi di other sono già distinti
                 current = current->next;
             }
         }catch (...){
@@ -126,121 +871,321 @@ public:
         }
     }
     /**
-     * @brief Operatore assegnamento
+     * @brief Operatore assegnamento
+     * 
+     * @param other set da copiare
+     * @return reference al set this
+     * 
+     * @post head == other._head
+     * @post _size == other._size
+     * @throw std::bad_alloc possibile eccezione di allocazione, this non viene alterato
+     * (con N > 0 la garanzia richiede che lo spostamento di T sia noexcept, altrimenti
+     * un'eccezione nella copia di T lascia this vuoto)
+     */
+
+    Set& operator=(const Set &other){
+        if (this != &other){
+            Set tmp(other);
+            take(tmp, std::integral_constant<bool, N == 0>());
+        }
+        return *this;
+    }
+    /**
+     * @brief Move constructor, si appropria dei nodi di other in O(1)
+     * 
+     * Con N > 0 i valori vengono spostati uno alla volta in O(n)
+     * 
+     * @param other set da cui spostare i dati
+     * @post other.isEmpty()
+     * @throw std::bad_alloc possibile eccezione di allocazione (solo con N > 0)
+     */
+    Set(Set &&other) noexcept(N == 0) : Set(std::move(other), std::integral_constant<bool, N == 0>()) {}
+    /**
+     * @brief Operatore assegnamento per spostamento
+     * 
+     * I nodi di this vengono rilasciati, quelli di other passano a this in O(1)
+     * (con N > 0 i valori vengono spostati uno alla volta)
+     * 
+     * @param other set da cui spostare i dati
+     * @return reference al set this
+     * @post other.isEmpty()
+     * @throw std::bad_alloc possibile eccezione di allocazione (solo con N > 0),
+     * this non viene alterato
+     */
+    Set& operator=(Set &&other) noexcept(N == 0){
+        if (this != &other)
+            take(other, std::integral_constant<bool, N == 0>());
+        return *this;
+    }
+    /**
+     * @brief Distruttore
+     * @post _head == nullptr
+     * @post _size == 0
+     * 
+     */
+    ~Set(){
+        clear();
+        free_positions();
+    }
+
+    /**
+     * @brief Costruttore secondario, costruisce un set a partire da due iteratori sul tipo Q
+     * 
+     * @tparam Q tipo dell'iteratore
+     * @param b iteratore di inizio
+     * @param e iteratore di fine
+     * 
+     */
+    template<typename Q> Set(Q b, Q e) : _head(nullptr), _tail(nullptr), _size(0), _table(nullptr), _capacity(0), _occupied(0), _fingerprint(0), _pool(){
+        try{
+            for(; b!=e; ++b)
+                add(static_cast<T>(*b));
+        }catch(...){
+            clear();
+            throw;
+        }
+    }
+    /**
+     * @brief Costruttore secondario con politica di esecuzione sequenziale
+     * 
+     * @param b iteratore di inizio
+     * @param e iteratore di fine
+     */
+    template<typename Q> Set(execution::sequenced_policy, Q b, Q e) : Set(b, e) {}
+
+    /**
+     * @brief Costruttore secondario con politica di esecuzione parallela
+     * 
+     * Se il set è indicizzato e Q è ad accesso casuale, i duplicati vengono
+     * eliminati in parallelo (vedi bulk_build) e i nodi collegati in un'unica
+     * passata; altrimenti si comporta come Set(b, e). 
+     * In entrambi i casi l'ordine è quello della prima occorrenza di ogni valore
+     * 
+     * @tparam Q tipo dell'iteratore
+     * @param b iteratore di inizio
+     * @param e iteratore di fine
+     * @throw std::bad_alloc possibile eccezione di allocazione
+     */
+    template<typename Q> Set(execution::parallel_policy, Q b, Q e) : _head(nullptr), _tail(nullptr), _size(0), _table(nullptr), _capacity(0), _occupied(0), _fingerprint(0), _pool(){
+        try{
+            build_from(b, e, typename std::iterator_traits<Q>::iterator_category());
+        }catch(...){
+            clear();
+            throw;
+        }
+    }
+    /**
+     * @brief Aggiunge un nuovo valore alla lista solo se quest'ultimo non
+     * è presente
+     * In caso fosse presente, non viene memorizzato.
+     * La ricerca del duplicato è l'unica scansione: l'aggancio in coda usa _tail
+     * @param value valore da memorizzare
+     * 
+     * @throw std::bad_alloc possibile eccezione di allocazione
+     */
+    void add(const T &value){
+        SET_STAT(scoped_latency timer(_stats.add);)
+        if (find_node(value) == nullptr)
+            append_unique(value);
+    }
+    /**
+     * @brief Aggiunge un nuovo valore spostandolo nel nodo, solo se non è presente
+     * In caso fosse presente, value non viene modificato
+     * 
+     * @param value valore da spostare
+     * @throw std::bad_alloc possibile eccezione di allocazione
+     */
+    void add(T &&value){
+        SET_STAT(scoped_latency timer(_stats.add);)
+        if (find_node(value) != nullptr)
+            return;
+        if (_indexed)
+            reserve_slot();
+        nodo *aus = create_node(std::move(value));
+        link_back(aus);
+        if (_indexed)
+            index_node(aus);
+    }
+    /**
+     * @brief Costruisce un valore direttamente nel nodo e lo aggiunge se non è presente
+     * 
+     * Il valore viene costruito prima del controllo dei duplicati: se è già 
+     * presente il nodo viene distrutto e il set non viene alterato
+     * 
+     * @tparam Args tipi degli argomenti del costruttore di T
+     * @param args argomenti del costruttore di T
+     * @throw std::bad_alloc possibile eccezione di allocazione
+     */
+    template<typename... Args>
+    void emplace(Args&&... args){
+        SET_STAT(scoped_latency timer(_stats.add);)
+        nodo *aus = create_node(emplace_tag(), std::forward<Args>(args)...);
+        try{
+            if (find_node(aus->value) != nullptr){
+                destroy_node(aus);
+                return;
+            }
+            if (_indexed)
+                reserve_slot();
+        }catch(...){
+            destroy_node(aus);
+            throw;
+        }
+        link_back(aus);
+        if (_indexed)
+            index_node(aus);
+    }
+    /**
+     * Rimuove il valore passato come parametro dalla lista solo
+     * se è presente
+     * 
+     * @param value valore da rimuovere
+     */
+    void remove(const T& value){
+        SET_STAT(scoped_latency timer(_stats.remove);)
+        erase_key(value);
+    }
+    /**
+     * @brief Rimuove l'elemento uguale alla chiave passata, solo se è presente
+     * 
+     * Disponibile se Eql e Hash sono trasparenti: nessun T temporaneo viene costruito
+     * 
+     * @tparam K tipo della chiave, confrontabile con T tramite Eql
+     * @param key chiave dell'elemento da rimuovere
+     */
+    template<typename K>
+    if_key<K, void> remove(const K &key){
+        SET_STAT(scoped_latency timer(_stats.remove);)
+        erase_key(key);
+    }
+    /**
+     * @brief Aggiunge gli elementi di other non presenti nel set this (unione sul posto)
      * 
-     * @param other set da copiare
-     * @return reference al set this
+     * O(|other|) se il set è indicizzato. Garanzia forte: in caso di eccezione
+     * gli elementi già accodati vengono rimossi
      * 
-     * @post head == other._head
-     * @post _size == other._size
+     * @param other set da aggiungere
+     * @return reference al set this
+     * @throw std::bad_alloc possibile eccezione di allocazione
      */
-
-    Set& operator=(const Set &other){
-        if (this != &other){
-            Set tmp(other);
-            std::swap(_head, tmp._head);
-            std::swap(_size, tmp._size);
+    Set& operator+=(const Set &other){
+        if (this == &other)
+            return *this;
+        nodo *last = _tail;
+        try{
+            for (nodo *current = other._head; current != nullptr; current = current->next)
+                if (find_node(current->value) == nullptr)
+                    append_unique(current->value);
+        }catch(...){
+            truncate_after(last);
+            throw;
         }
         return *this;
     }
     /**
-     * @brief Distruttore
-     * @post _head == nullptr
-     * @post _size == 0
+     * @brief Unione sul posto che ricollega i nodi di other invece di copiarne i valori
      * 
+     * Se gli allocatori sono uguali e N == 0, this adotta i blocchi di memoria di other:
+     * i nodi nuovi vengono agganciati in coda, i duplicati distrutti. 
+     * Altrimenti i valori vengono copiati come in operator+=(const Set&)
+     * 
+     * @param other set da cui prendere gli elementi
+     * @return reference al set this
+     * @post other.isEmpty()
+     * @throw std::bad_alloc possibile eccezione di allocazione (prima di modificare i set)
      */
-    ~Set(){
-        clear();
+    Set& operator+=(Set &&other){
+        if (this != &other)
+            absorb(other, std::integral_constant<bool, N == 0>());
+        return *this;
     }
-
     /**
-     * @brief Costruttore secondario, costruisce un set a partire da due iteratori sul tipo Q
+     * @brief Mantiene solo gli elementi presenti anche in other (intersezione sul posto)
      * 
-     * @tparam Q tipo dell'iteratore
-     * @param b iteratore di inizio
-     * @param e iteratore di fine
+     * I nodi esclusi vengono scollegati, nessun valore viene copiato.
+     * Garanzia forte: i nodi da rimuovere sono individuati prima di modificare il set
      * 
+     * @param other set con cui fare l'intersezione
+     * @return reference al set this
+     * @throw std::bad_alloc possibile eccezione di allocazione
      */
-    template<typename Q> Set(Q b, Q e) : _head(nullptr), _size(0){
-        try{
-            for(; b!=e; ++b)
-                add(static_cast<T>(*b));
-        }catch(...){
-            clear();
-            throw;
+    Set& operator-=(const Set &other){
+        if (this != &other){
+            std::vector<nodo*> victims;
+            for (nodo *current = _head; current != nullptr; current = current->next)
+                if (!other.contains(current->value))
+                    victims.push_back(current);
+            for (unsigned int i = 0; i < victims.size(); ++i)
+                erase_node(victims[i]);
         }
+        return *this;
     }
     /**
-     * @brief Aggiunge un nuovo valore alla lista solo se quest'ultimo non
-     * è presente
-     * In caso fosse presente, non viene memorizzato
-     * @param value valore da memorizzare
+     * @brief Rimuove gli elementi che soddisfano il predicato
      * 
-     * @throw std::bad_alloc possibile eccezione di allocazione
+     * Il predicato viene valutato su tutti gli elementi prima di scollegare
+     * i nodi: se lancia un'eccezione il set non viene alterato
+     * 
+     * @tparam P tipo del predicato
+     * @param pred predicato sugli elementi
+     * @return numero di elementi rimossi
      */
-    void add(const T &value){
-        if (!contains(value)){
-            nodo *current = _head;
-            nodo *aus = new nodo(value);
-            if (current == nullptr){ //set vuoto
-                _head = aus;
-                _size++;
-                return;
-            }else{
-                nodo *previous = _head;
-                while(current!=nullptr){//set pieno
-                    previous=current;
-                    current=current->next;
-                }
-                previous->next=aus;
-                _size++;
-            }
-        }
+    template<typename P>
+    unsigned int erase_if(P pred){
+        std::vector<nodo*> victims;
+        for (nodo *current = _head; current != nullptr; current = current->next)
+            if (pred(current->value))
+                victims.push_back(current);
+        for (unsigned int i = 0; i < victims.size(); ++i)
+            erase_node(victims[i]);
+        return victims.size();
     }
     /**
-     * Rimuove il valore passato come parametro dalla lista solo
-     * se è presente
+     * @brief Mantiene solo gli elementi che soddisfano il predicato
      * 
-     * @param value valore da rimuovere
+     * @tparam P tipo del predicato
+     * @param pred predicato sugli elementi
+     * @return numero di elementi rimossi
      */
-    void remove(const T& value){
-        if(contains(value)){
-            nodo *current=_head;
-            nodo *previous=_head;
-
-            if(_equals(current->value, value)){ //rimozione in testa
-                _head=current->next;
-                delete current;
-                _size--;
-                return;
-            }
-
-            while(current!=nullptr){ //rimozione in coda e al centro della lista
-                if(_equals(value, current->value)){
-                    previous->next=current->next;
-                    delete current;
-                    _size--;
-                    return;
-                }
-                previous=current;
-                current=current->next;
-            }
-        }
+    template<typename P>
+    unsigned int retain_if(P pred){
+        return erase_if([&pred](const T &value){ return !pred(value); });
     }
     /**
      * @brief Svuota la lista
+     * 
+     * I valori vengono distrutti (nessun ciclo se T ha distruttore banale) e
+     * la memoria dei nodi viene restituita all'allocatore in blocco
      * @post _head == nullptr
      * @post _size == 0
      */
     void clear(){
-        nodo *current = _head;
-        while (current != nullptr){
-            nodo *next_node = current->next;
-            delete current;
-            current = next_node;
+        if (!std::is_trivially_destructible<T>::value){
+            nodo *current = _head;
+            while (current != nullptr){
+                nodo *next_node = current->next;
+                current->~nodo();
+                current = next_node;
+            }
         }
+        _pool.release();
+        SET_STAT(_stats.deallocations += _size;)
+        clear_positions();
         _head = nullptr;
+        _tail = nullptr;
         _size = 0;
+        free_table();
+        _capacity = 0;
+        _occupied = 0;
+        _fingerprint = 0;
+    }
+    /**
+     * @brief Allocatore usato dal set
+     * 
+     * @return copia dell'allocatore
+     */
+    Alloc get_allocator() const{
+        return _pool.get_allocator();
     }
     /** Ritorna il numero degli elementi salvati
      * 
@@ -266,44 +1211,101 @@ public:
      * @return false se il valore non è presente
      */
     bool contains(const T &value) const{
-        nodo *current = _head;
-        while (current != nullptr){
-            if (_equals(current->value, value))
-                return true;
-            current = current->next;
-        }
-        return false;
+        SET_STAT(scoped_latency timer(_stats.contains);)
+        return find_node(value) != nullptr;
+    }
+    /**
+     * @brief Verifica se un elemento uguale alla chiave passata è contenuto nel set
+     * 
+     * Disponibile se Eql e Hash sono trasparenti: nessun T temporaneo viene costruito
+     * 
+     * @tparam K tipo della chiave, confrontabile con T tramite Eql
+     * @param key chiave da cercare
+     * @return true se un elemento uguale a key è presente
+     */
+    template<typename K>
+    if_key<K, bool> contains(const K &key) const{
+        SET_STAT(scoped_latency timer(_stats.contains);)
+        return find_node(key) != nullptr;
     }
     /**
      * @brief Ritorna l'i-esimo valore della lista
      * 
+     * I nodi già visitati sono salvati in una cache: l'accesso è O(1) per gli
+     * indici nella cache, che viene estesa dall'ultimo nodo noto fino a index.
+     * Un ciclo su tutti gli indici costa quindi O(n). Gli inserimenti in coda
+     * lasciano valida la cache, una rimozione la tronca alla posizione del nodo
+     * rimosso. La cache ha un proprio mutex: come le altre funzioni costanti,
+     * operator[] può essere chiamato da più thread sullo stesso set, purché
+     * nessuno lo modifichi. Il prezzo è un lock non conteso a ogni chiamata
+     * (misura index del benchmark, da confrontare con iterate) e un rank per
+     * nodo; per scorrere tutto il set gli iteratori restano più economici
+     * 
      * @param index indice del valore nella lista
      * @return const T& reference del valore ritornato
      * 
      * @throw set_index_out_of_bound eccezione indice fuori range
+     * @throw std::bad_alloc possibile eccezione di allocazione della cache
      */
     const T& operator[](int index) const{ 
+        SET_STAT(scoped_latency timer(_stats.index);)
         if (index < 0 || index >= _size)
             throw set_index_out_of_bound("Cannot read the value with an index out of bound");
         
-        int i = 0;
-        nodo *current = _head;
-        bool found=false;
-        nodo *previous=_head;
-        while (current != nullptr && !found) {
-            if (index == i)
-                found=true;
-            
-            i++;
-            previous=current;
-            current = current->next;
+        unsigned int i = static_cast<unsigned int>(index);
+        position_cache &cache = positions();
+        std::lock_guard<std::mutex> lock(cache.mutex);
+        std::vector<nodo*, table_allocator> &nodes = cache.nodes;
+        if (i >= nodes.size()){
+            if (nodes.capacity() < _size)
+                nodes.reserve(_size);
+            nodo *current = nodes.empty() ? _head : nodes.back()->next;
+            while (nodes.size() <= i){
+                SET_STAT(_stats.nodes_traversed++;)
+                current->rank = static_cast<unsigned int>(nodes.size());
+                nodes.push_back(current);
+                current = current->next;
+            }
         }
-        return previous->value;
-         
+        return nodes[i]->value;
+    }
+    /**
+     * @brief Impronta del contenuto del set, indipendente dall'ordine di inserimento
+     * 
+     * Mantenuta in O(1) da add e remove; due set uguali hanno la stessa impronta
+     * 
+     * @return impronta del contenuto, 0 se il set non è indicizzato
+     */
+    std::size_t fingerprint() const{
+        return _fingerprint;
+    }
+#ifdef SET_INSTRUMENTATION
+    /**
+     * @brief Contatori raccolti dalla costruzione o dall'ultimo reset_stats
+     *
+     * Disponibile solo compilando con -DSET_INSTRUMENTATION. I contatori
+     * appartengono all'oggetto: copie, spostamenti e swap non li trasferiscono
+     *
+     * @return reference costante ai contatori
+     */
+    const set_stats& stats() const{
+        return _stats;
+    }
+    /**
+     * @brief Azzera i contatori
+     */
+    void reset_stats(){
+        _stats.reset();
     }
+#endif
     /**
      * @brief Operatore == che verifica che due set sono uguali, cioè contengono gli stessi elementi
      * 
+     * Con l'indice hash il confronto delle impronte scarta in O(1) quasi tutti i set
+     * diversi, poi ogni elemento di other viene cercato nella tabella: O(n).
+     * Senza indice vengono confrontati in parallelo i prefissi nello stesso ordine
+     * (O(n) per le copie) e solo gli elementi restanti vengono cercati nella 
+     * parte restante di this
      * 
      * @param other set con cui fare il confronto 
      * @return true se il set this contiene gli stessi dati di other, o se entrambi sono vuoti
@@ -313,20 +1315,31 @@ public:
     bool operator==(const Set &other) const{
         if(_size != other._size)
             return false;
-        
-        nodo *current = other._head;    
 
-        if(isEmpty() && other.isEmpty())
+        if(_indexed){
+            if(_fingerprint != other._fingerprint)
+                return false;
+            for(nodo *current = other._head; current != nullptr; current = current->next)
+                if(find_slot(current->value) == _capacity)
+                    return false;
             return true;
+        }
 
-        bool equals=false;
-        while(current!=nullptr){
-            equals=contains(current->value);
-            if(!equals)
+        nodo *mine = _head;
+        nodo *current = other._head;
+        while(current != nullptr && _equals(mine->value, current->value)){
+            mine = mine->next;
+            current = current->next;
+        }
+        //gli elementi restanti di other non possono coincidere con il prefisso comune
+        for(; current != nullptr; current = current->next){
+            nodo *n = mine;
+            while(n != nullptr && !_equals(n->value, current->value))
+                n = n->next;
+            if(n == nullptr)
                 return false;
-            current=current->next;
         }
-        return equals;
+        return true;
     }
     /**
      * @brief Operatore di stream
@@ -342,6 +1355,32 @@ public:
         }
         return os;
     }
+    /**
+     * @brief Operatore di stream in ingresso, inverso di operator<<
+     * 
+     * Legge valori separati da spazi fino alla fine dello stream e li aggiunge
+     * al set (i duplicati vengono ignorati). La fine dello stream è pulita (solo
+     * eofbit) se dopo l'ultimo valore restano solo spazi; se un valore non può
+     * essere letto, anche un token finale incompleto come "-" per int, lo
+     * stream resta in stato di errore. I valori letti prima restano nel set
+     * 
+     * @param is stream di input
+     * @param s set a cui aggiungere i valori
+     * @return reference dello stream di input
+     * @throw std::bad_alloc possibile eccezione di allocazione
+     */
+    friend std::istream& operator>>(std::istream &is, Set &s){
+        T value;
+        while(!is.eof()){
+            is>>std::ws;
+            if(is.eof())
+                break; //solo spazi fino alla fine: nessun errore
+            if(!(is>>value))
+                break; //token non valido, anche se consuma lo stream fino alla fine
+            s.add(std::move(value));
+        }
+        return is;
+    }
 
      /**
      * Classe const_iterator
@@ -473,27 +1512,279 @@ public:
 	const_iterator end() const {
 		return const_iterator(nullptr);
 	}
+	/**
+	 * @brief Cerca il valore passato con una sola scansione (una sonda se indicizzato)
+	 * 
+	 * @param value valore da cercare
+	 * @return iteratore all'elemento, end() se non è presente
+	 */
+	const_iterator find(const T &value) const {
+		SET_STAT(scoped_latency timer(_stats.contains);)
+		return const_iterator(find_node(value));
+	}
+	/**
+	 * @brief Cerca l'elemento uguale alla chiave passata, senza costruire un T temporaneo
+	 * 
+	 * @tparam K tipo della chiave, confrontabile con T tramite Eql (Eql e Hash trasparenti)
+	 * @param key chiave da cercare
+	 * @return iteratore all'elemento, end() se non è presente
+	 */
+	template<typename K>
+	if_key<K, const_iterator> find(const K &key) const {
+		SET_STAT(scoped_latency timer(_stats.contains);)
+		return const_iterator(find_node(key));
+	}
+	/**
+	 * @brief Aggiunge il valore se non è presente e indica se è stato inserito
+	 *
+	 * Come add esegue una sola ricerca: evita la coppia contains + add
+	 *
+	 * @param value valore da memorizzare
+	 * @return iteratore all'elemento uguale a value (nuovo o già presente) e
+	 * true se l'inserimento è avvenuto
+	 * @throw std::bad_alloc possibile eccezione di allocazione
+	 */
+	std::pair<const_iterator, bool> insert(const T &value) {
+		SET_STAT(scoped_latency timer(_stats.add);)
+		return insert_value(value);
+	}
+	/**
+	 * @brief Sposta il valore nel set se non è presente e indica se è stato inserito
+	 * In caso fosse presente, value non viene modificato
+	 *
+	 * @param value valore da spostare
+	 * @return iteratore all'elemento uguale a value e true se l'inserimento è avvenuto
+	 * @throw std::bad_alloc possibile eccezione di allocazione
+	 */
+	std::pair<const_iterator, bool> insert(T &&value) {
+		SET_STAT(scoped_latency timer(_stats.add);)
+		return insert_value(std::move(value));
+	}
+	/**
+	 * @brief Costruisce un elemento nel nodo solo se key non è presente
+	 *
+	 * A differenza di emplace, la ricerca del duplicato usa key e precede la
+	 * costruzione: se l'elemento esiste gli argomenti non vengono toccati e
+	 * nessun T viene costruito. Senza argomenti l'elemento è costruito da key
+	 *
+	 * @tparam K tipo della chiave: T, oppure qualunque tipo se Eql e Hash sono
+	 * trasparenti (altrimenti ogni sonda costruirebbe un T temporaneo)
+	 * @tparam Args tipi degli argomenti del costruttore di T
+	 * @param key chiave da cercare
+	 * @param args argomenti del costruttore di T
+	 * @return iteratore all'elemento uguale a key e true se l'inserimento è avvenuto
+	 * @throw std::invalid_argument se l'elemento costruito da args è diverso da
+	 * key: l'elemento viene distrutto e il set non cambia
+	 * @throw std::bad_alloc possibile eccezione di allocazione
+	 */
+	template<typename K, typename... Args>
+	if_value_or_key<K, std::pair<const_iterator, bool> > try_emplace(const K &key, Args&&... args) {
+		SET_STAT(scoped_latency timer(_stats.add);)
+		nodo *n = find_node(key);
+		if (n != nullptr)
+			return std::pair<const_iterator, bool>(const_iterator(n), false);
+		if (_indexed)
+			reserve_slot();
+		if constexpr (sizeof...(Args) == 0)
+			n = create_node(emplace_tag(), key);
+		else
+			n = create_node(emplace_tag(), std::forward<Args>(args)...);
+		if (!_equals(n->value, key)) {
+			destroy_node(n);
+			throw std::invalid_argument("try_emplace: element differs from key");
+		}
+		link_back(n);
+		if (_indexed)
+			index_node(n);
+		return std::pair<const_iterator, bool>(const_iterator(n), true);
+	}
+
+private:
+	/**
+	 * @brief Corpo comune di insert: una ricerca, poi l'aggancio in coda
+	 */
+	template<typename V>
+	std::pair<const_iterator, bool> insert_value(V &&value) {
+		nodo *n = find_node(value);
+		if (n != nullptr)
+			return std::pair<const_iterator, bool>(const_iterator(n), false);
+		append_unique(std::forward<V>(value));
+		return std::pair<const_iterator, bool>(const_iterator(_tail), true);
+	}
 	
 };
+/**
+ * @brief Algoritmi di supporto alle operazioni tra set
+ * 
+ * Per ogni elemento di A e di B calcolano se compare anche nell'altro set 
+ * (vettori di flag); unione, intersezione, differenza e differenza simmetrica 
+ * vengono poi costruite in un'unica passata accodando valori già noti come 
+ * distinti, senza ricerca dei duplicati nel risultato
+ * 
+ * @tparam S tipo dei set
+ */
+template<typename T, typename Eql, typename Hash, typename Alloc, unsigned int N>
+struct set_ops<Set<T, Eql, Hash, Alloc, N> >{
+    typedef Set<T, Eql, Hash, Alloc, N> set_type;
+
+    /**
+     * @brief Flag di appartenenza usando contains dei due set
+     * 
+     * O(|A|+|B|) se i set sono indicizzati, O(|A|·|B|) altrimenti
+     * 
+     * @param in_b in_b[i] == true se l'i-esimo elemento di A è in B
+     * @param in_a in_a[j] == true se il j-esimo elemento di B è in A (calcolato solo se richiesto)
+     */
+    static void membership(const set_type &A, const set_type &B, std::vector<bool> &in_b, std::vector<bool> *in_a){
+        typename set_type::const_iterator i, e;
+        in_b.reserve(A.size());
+        for(i=A.begin(), e=A.end(); i!=e; ++i)
+            in_b.push_back(B.contains(*i));
+        if(in_a == nullptr)
+            return;
+        in_a->reserve(B.size());
+        for(i=B.begin(), e=B.end(); i!=e; ++i)
+            in_a->push_back(A.contains(*i));
+    }
+    /**
+     * @brief Flag di appartenenza tramite un indice temporaneo sul set più piccolo
+     * 
+     * Il set più piccolo viene indicizzato in una tabella a indirizzamento aperto
+     * di posizioni; ogni elemento del set più grande viene cercato una volta sola
+     * e marca l'elemento trovato. O(|A|+|B|) atteso, memoria O(min(|A|,|B|))
+     * 
+     * @param h funtore hash su T coerente con Eql
+     * @param in_b in_b[i] == true se l'i-esimo elemento di A è in B
+     * @param in_a in_a[j] == true se il j-esimo elemento di B è in A
+     */
+    template<typename H>
+    static void membership(const set_type &A, const set_type &B, H h, std::vector<bool> &in_b, std::vector<bool> &in_a){
+        bool a_small = A.size() <= B.size();
+        const set_type &small = a_small ? A : B;
+        const set_type &large = a_small ? B : A;
+        std::vector<bool> &small_flags = a_small ? in_b : in_a;
+        std::vector<bool> &large_flags = a_small ? in_a : in_b;
+        Eql equals;
+
+        std::vector<const T*> values;
+        values.reserve(small.size());
+        typename set_type::const_iterator i, e;
+        for(i=small.begin(), e=small.end(); i!=e; ++i)
+            values.push_back(&(*i));
+
+        unsigned int capacity = 16;
+        while(capacity < values.size() * 2)
+            capacity *= 2;
+        std::vector<unsigned int> table(capacity, 0); //posizione+1 in values, 0 se vuoto
+        for(unsigned int k = 0; k < values.size(); ++k){
+            unsigned int slot = static_cast<unsigned int>((static_cast<unsigned long long>(h(*values[k])) * 0x9E3779B97F4A7C15ULL) >> 32) & (capacity - 1);
+            while(table[slot] != 0)
+                slot = (slot + 1) & (capacity - 1);
+            table[slot] = k + 1;
+        }
+
+        small_flags.assign(small.size(), false);
+        large_flags.reserve(large.size());
+        for(i=large.begin(), e=large.end(); i!=e; ++i){
+            unsigned int slot = static_cast<unsigned int>((static_cast<unsigned long long>(h(*i)) * 0x9E3779B97F4A7C15ULL) >> 32) & (capacity - 1);
+            bool found = false;
+            while(table[slot] != 0){
+                if(equals(*values[table[slot] - 1], *i)){
+                    small_flags[table[slot] - 1] = true;
+                    found = true;
+                    break;
+                }
+                slot = (slot + 1) & (capacity - 1);
+            }
+            large_flags.push_back(found);
+        }
+    }
+    /**
+     * @brief Accoda al risultato gli elementi di S il cui flag vale keep
+     * 
+     * @param result set a cui accodare gli elementi
+     * @param S set di provenienza
+     * @param flags flag degli elementi di S
+     * @param keep valore del flag degli elementi da accodare
+     */
+    static void append_if(set_type &result, const set_type &S, const std::vector<bool> &flags, bool keep){
+        typename set_type::const_iterator i, e;
+        unsigned int k = 0;
+        for(i=S.begin(), e=S.end(); i!=e; ++i, ++k)
+            if(flags[k] == keep)
+                result.append_unique(*i);
+    }
+    /**
+     * @brief Accoda al risultato un valore già noto come assente
+     */
+    static void append(set_type &result, const T &value){
+        result.append_unique(value);
+    }
+    /**
+     * @brief Accoda al risultato, spostandolo, un valore già noto come assente
+     */
+    static void append(set_type &result, T &&value){
+        result.append_unique(std::move(value));
+    }
+    /**
+     * @brief Accoda al risultato tutti gli elementi di S
+     */
+    static void append_all(set_type &result, const set_type &S){
+        typename set_type::const_iterator i, e;
+        for(i=S.begin(), e=S.end(); i!=e; ++i)
+            result.append_unique(*i);
+    }
+    /**
+     * @brief Unione: A seguito dagli elementi di B non presenti in A
+     */
+    static set_type unite(const set_type &A, const set_type &B, const std::vector<bool> &in_a){
+        set_type result;
+        append_all(result, A);
+        append_if(result, B, in_a, false);
+        return result;
+    }
+    /**
+     * @brief Elementi di A il cui flag di appartenenza a B vale keep
+     */
+    static set_type select(const set_type &A, const std::vector<bool> &in_b, bool keep){
+        set_type result;
+        append_if(result, A, in_b, keep);
+        return result;
+    }
+    /**
+     * @brief Differenza simmetrica: elementi di A non in B seguiti da elementi di B non in A
+     */
+    static set_type symmetric(const set_type &A, const set_type &B, const std::vector<bool> &in_b, const std::vector<bool> &in_a){
+        set_type result;
+        append_if(result, A, in_b, false);
+        append_if(result, B, in_a, false);
+        return result;
+    }
+};
+
 /**
  * @brief Filtra dal set S i valori che soffisfano il predicato P
  * 
+ * Gli elementi di S sono distinti: vengono accodati senza ricerca dei duplicati, O(|S|)
+ * 
  * @tparam T tipo dell'oggetto set
  * @tparam Eql funtore di uguaglianza dell'oggetto set
+ * @tparam Hash funtore hash dell'oggetto set
+ * @tparam Alloc allocatore dell'oggetto set
  * @tparam P tipo del funtore
  * @param S oggetto set
  * @param pred funtore predicato
- * @return Set<T, Eql> nuovo set che contiene i valori di S che soddisfano il predicato P
+ * @return Set<T, Eql, Hash, Alloc, N> nuovo set che contiene i valori di S che soddisfano il predicato P
  * @throw std::bad_alloc eccezzione nel caso di cattiva allocazione della memoria
  */
-template<typename T, typename Eql, typename P> 
-Set<T, Eql> filter_out(const Set<T, Eql> &S, P pred){
-    Set<T, Eql> filtered_set;
-    typename Set<T, Eql>::const_iterator b, e;
+template<typename T, typename Eql, typename Hash, typename Alloc, unsigned int N, typename P> 
+Set<T, Eql, Hash, Alloc, N> filter_out(const Set<T, Eql, Hash, Alloc, N> &S, P pred){
+    Set<T, Eql, Hash, Alloc, N> filtered_set;
+    typename Set<T, Eql, Hash, Alloc, N>::const_iterator b, e;
     try{
         for(b=S.begin(),e=S.end(); b!=e; ++b)
             if(pred(*b))
-                filtered_set.add(*b);
+                set_ops<Set<T, Eql, Hash, Alloc, N> >::append(filtered_set, *b); //gli elementi di S sono già distinti
     }catch(...){
         filtered_set.clear();
         throw;
@@ -501,55 +1792,209 @@ Set<T, Eql> filter_out(const Set<T, Eql> &S, P pred){
     
     return filtered_set;
 }
+/**
+ * @brief filter_out con politica di esecuzione sequenziale
+ * 
+ * @return Set<T, Eql, Hash, Alloc, N> nuovo set che contiene i valori di S che soddisfano il predicato P
+ */
+template<typename T, typename Eql, typename Hash, typename Alloc, unsigned int N, typename P>
+Set<T, Eql, Hash, Alloc, N> filter_out(execution::sequenced_policy, const Set<T, Eql, Hash, Alloc, N> &S, P pred){
+    return filter_out(S, pred);
+}
+/**
+ * @brief filter_out con politica di esecuzione parallela
+ * 
+ * Il set viene diviso in blocchi contigui di nodi; ogni blocco è valutato da un 
+ * thread (il chiamante compreso) che scrive l'esito del predicato in un vettore
+ * di flag. Il risultato viene poi costruito sequenzialmente nell'ordine originale.
+ * Il predicato deve poter essere invocato in modo concorrente
+ * 
+ * @tparam T tipo dell'oggetto set
+ * @tparam Eql funtore di uguaglianza dell'oggetto set
+ * @tparam Hash funtore hash dell'oggetto set
+ * @tparam Alloc allocatore dell'oggetto set
+ * @tparam P tipo del funtore
+ * @param S oggetto set
+ * @param pred funtore predicato
+ * @return Set<T, Eql, Hash, Alloc, N> nuovo set che contiene i valori di S che soddisfano il predicato P
+ * @throw std::bad_alloc eccezzione nel caso di cattiva allocazione della memoria
+ * @throw la prima eccezione lanciata dal predicato, dopo la terminazione di tutti i thread
+ */
+template<typename T, typename Eql, typename Hash, typename Alloc, unsigned int N, typename P>
+Set<T, Eql, Hash, Alloc, N> filter_out(execution::parallel_policy, const Set<T, Eql, Hash, Alloc, N> &S, P pred){
+    typedef typename Set<T, Eql, Hash, Alloc, N>::const_iterator iterator;
+    unsigned int n = S.size();
+    unsigned int workers = execution::worker_count(n);
+    if(workers <= 1)
+        return filter_out(S, pred);
+
+    unsigned int chunk = (n + workers - 1) / workers;
+    std::vector<iterator> starts;
+    iterator b, e;
+    unsigned int i = 0;
+    for(b=S.begin(), e=S.end(); b!=e; ++b, ++i)
+        if(i % chunk == 0)
+            starts.push_back(b);
+    starts.push_back(e);
+    workers = starts.size() - 1;
+
+    std::vector<char> keep(n, 0); //char e non bool: ogni thread scrive byte distinti
+    execution::parallel_for(workers, [&](unsigned int w){
+        unsigned int k = w * chunk;
+        for(iterator it = starts[w]; it != starts[w + 1]; ++it, ++k)
+            keep[k] = pred(*it) ? 1 : 0;
+    });
+
+    Set<T, Eql, Hash, Alloc, N> filtered_set;
+    unsigned int k = 0;
+    for(b=S.begin(); b!=e; ++b, ++k)
+        if(keep[k])
+            set_ops<Set<T, Eql, Hash, Alloc, N> >::append(filtered_set, *b);
+    return filtered_set;
+}
 
 /**
  * @brief Operator+
  * 
+ * O(|A|+|B|) se i set sono indicizzati, altrimenti O(|A|·|B|): per i set senza
+ * indice usare set_union con un funtore hash
+ * 
  * @tparam T tipo dell'oggetto set
  * @tparam Eql funtore di uguaglianza dell'oggetto set
+ * @tparam Hash funtore hash dell'oggetto set
+ * @tparam Alloc allocatore dell'oggetto set
  * @param A oggetto set di sinistra
  * @param B oggetto set di destra
- * @return Set<T, Eql> nuovo set che contiene i valori presenti in A o B
+ * @return Set<T, Eql, Hash, Alloc, N> nuovo set che contiene i valori presenti in A o B
  * @throw std::bad_alloc eccezzione nel caso di cattiva allocazione della memoria
  */
-template<typename T, typename Eql>
-Set<T, Eql> operator+(const Set<T, Eql> &A, const Set<T, Eql> &B){
-    Set<T, Eql> union_set(A);
-    typename Set<T, Eql>::const_iterator b, e;
-    try{
-        for(b=B.begin(),e=B.end(); b!=e; ++b)
-            union_set.add(*b);
-    }catch(...){
-        union_set.clear();
-        throw;
-    }
-
-    return union_set;
+template<typename T, typename Eql, typename Hash, typename Alloc, unsigned int N>
+Set<T, Eql, Hash, Alloc, N> operator+(const Set<T, Eql, Hash, Alloc, N> &A, const Set<T, Eql, Hash, Alloc, N> &B){
+    typedef set_ops<Set<T, Eql, Hash, Alloc, N> > ops;
+    std::vector<bool> in_a;
+    ops::membership(B, A, in_a, nullptr);
+    return ops::unite(A, B, in_a);
 }
 /**
  * @brief Operator-
  * 
+ * O(|A|+|B|) se i set sono indicizzati, altrimenti O(|A|·|B|): per i set senza
+ * indice usare set_intersection con un funtore hash
+ * 
  * @tparam T tipo dell'oggetto set
  * @tparam Eql funtore di uguaglianza dell'oggetto set
+ * @tparam Hash funtore hash dell'oggetto set
+ * @tparam Alloc allocatore dell'oggetto set
  * @param A oggetto set di sinistra
  * @param B oggetto set di destra
- * @return Set<T, Eql> nuovo set che contiene i valori presenti in A e B
+ * @return Set<T, Eql, Hash, Alloc, N> nuovo set che contiene i valori presenti in A e B
  * @throw std::bad_alloc eccezzione nel caso di cattiva allocazione della memoria
  */
-template<typename T, typename Eql>
-Set<T, Eql> operator-(const Set<T, Eql> &A, const Set<T, Eql> &B){
-    Set<T, Eql> intersect_set;
-    typename Set<T, Eql>::const_iterator b, e;
-    try{
-        for(b=A.begin(),e=A.end(); b!=e; ++b)
-            if(B.contains(*b))
-                intersect_set.add(*b);
-    }catch(...){
-        intersect_set.clear();
-        throw;
-    }
-    return intersect_set;
+template<typename T, typename Eql, typename Hash, typename Alloc, unsigned int N>
+Set<T, Eql, Hash, Alloc, N> operator-(const Set<T, Eql, Hash, Alloc, N> &A, const Set<T, Eql, Hash, Alloc, N> &B){
+    typedef set_ops<Set<T, Eql, Hash, Alloc, N> > ops;
+    std::vector<bool> in_b;
+    ops::membership(A, B, in_b, nullptr);
+    return ops::select(A, in_b, true);
+}
+/**
+ * @brief Differenza: elementi di A che non sono in B
+ * 
+ * @param A oggetto set di sinistra
+ * @param B oggetto set di destra
+ * @return Set<T, Eql, Hash, Alloc, N> nuovo set che contiene i valori presenti in A ma non in B
+ * @throw std::bad_alloc eccezzione nel caso di cattiva allocazione della memoria
+ */
+template<typename T, typename Eql, typename Hash, typename Alloc, unsigned int N>
+Set<T, Eql, Hash, Alloc, N> difference(const Set<T, Eql, Hash, Alloc, N> &A, const Set<T, Eql, Hash, Alloc, N> &B){
+    typedef set_ops<Set<T, Eql, Hash, Alloc, N> > ops;
+    std::vector<bool> in_b;
+    ops::membership(A, B, in_b, nullptr);
+    return ops::select(A, in_b, false);
+}
+/**
+ * @brief Differenza simmetrica: elementi presenti in uno solo dei due set
+ * 
+ * @param A oggetto set di sinistra
+ * @param B oggetto set di destra
+ * @return Set<T, Eql, Hash, Alloc, N> nuovo set con gli elementi di A non in B seguiti da quelli di B non in A
+ * @throw std::bad_alloc eccezzione nel caso di cattiva allocazione della memoria
+ */
+template<typename T, typename Eql, typename Hash, typename Alloc, unsigned int N>
+Set<T, Eql, Hash, Alloc, N> symmetric_difference(const Set<T, Eql, Hash, Alloc, N> &A, const Set<T, Eql, Hash, Alloc, N> &B){
+    typedef set_ops<Set<T, Eql, Hash, Alloc, N> > ops;
+    std::vector<bool> in_b, in_a;
+    ops::membership(A, B, in_b, &in_a);
+    return ops::symmetric(A, B, in_b, in_a);
+}
+/**
+ * @brief Unione in O(|A|+|B|) atteso anche per set senza indice
+ * 
+ * @tparam H tipo del funtore hash, coerente con Eql
+ * @param A oggetto set di sinistra
+ * @param B oggetto set di destra
+ * @param h funtore hash usato per indicizzare temporaneamente il set più piccolo
+ * @return Set<T, Eql, Hash, Alloc, N> nuovo set che contiene i valori presenti in A o B
+ * @throw std::bad_alloc eccezzione nel caso di cattiva allocazione della memoria
+ */
+template<typename T, typename Eql, typename Hash, typename Alloc, unsigned int N, typename H>
+Set<T, Eql, Hash, Alloc, N> set_union(const Set<T, Eql, Hash, Alloc, N> &A, const Set<T, Eql, Hash, Alloc, N> &B, H h){
+    typedef set_ops<Set<T, Eql, Hash, Alloc, N> > ops;
+    std::vector<bool> in_b, in_a;
+    ops::membership(A, B, h, in_b, in_a);
+    return ops::unite(A, B, in_a);
+}
+/**
+ * @brief Intersezione in O(|A|+|B|) atteso anche per set senza indice
+ * 
+ * @tparam H tipo del funtore hash, coerente con Eql
+ * @param A oggetto set di sinistra
+ * @param B oggetto set di destra
+ * @param h funtore hash usato per indicizzare temporaneamente il set più piccolo
+ * @return Set<T, Eql, Hash, Alloc, N> nuovo set che contiene i valori presenti in A e B
+ * @throw std::bad_alloc eccezzione nel caso di cattiva allocazione della memoria
+ */
+template<typename T, typename Eql, typename Hash, typename Alloc, unsigned int N, typename H>
+Set<T, Eql, Hash, Alloc, N> set_intersection(const Set<T, Eql, Hash, Alloc, N> &A, const Set<T, Eql, Hash, Alloc, N> &B, H h){
+    typedef set_ops<Set<T, Eql, Hash, Alloc, N> > ops;
+    std::vector<bool> in_b, in_a;
+    ops::membership(A, B, h, in_b, in_a);
+    return ops::select(A, in_b, true);
+}
+/**
+ * @brief Differenza in O(|A|+|B|) atteso anche per set senza indice
+ * 
+ * @tparam H tipo del funtore hash, coerente con Eql
+ * @param A oggetto set di sinistra
+ * @param B oggetto set di destra
+ * @param h funtore hash usato per indicizzare temporaneamente il set più piccolo
+ * @return Set<T, Eql, Hash, Alloc, N> nuovo set che contiene i valori presenti in A ma non in B
+ * @throw std::bad_alloc eccezzione nel caso di cattiva allocazione della memoria
+ */
+template<typename T, typename Eql, typename Hash, typename Alloc, unsigned int N, typename H>
+Set<T, Eql, Hash, Alloc, N> difference(const Set<T, Eql, Hash, Alloc, N> &A, const Set<T, Eql, Hash, Alloc, N> &B, H h){
+    typedef set_ops<Set<T, Eql, Hash, Alloc, N> > ops;
+    std::vector<bool> in_b, in_a;
+    ops::membership(A, B, h, in_b, in_a);
+    return ops::select(A, in_b, false);
+}
+/**
+ * @brief Differenza simmetrica in O(|A|+|B|) atteso anche per set senza indice
+ * 
+ * @tparam H tipo del funtore hash, coerente con Eql
+ * @param A oggetto set di sinistra
+ * @param B oggetto set di destra
+ * @param h funtore hash usato per indicizzare temporaneamente il set più piccolo
+ * @return Set<T, Eql, Hash, Alloc, N> nuovo set con gli elementi di A non in B seguiti da quelli di B non in A
+ * @throw std::bad_alloc eccezzione nel caso di cattiva allocazione della memoria
+ */
+template<typename T, typename Eql, typename Hash, typename Alloc, unsigned int N, typename H>
+Set<T, Eql, Hash, Alloc, N> symmetric_difference(const Set<T, Eql, Hash, Alloc, N> &A, const Set<T, Eql, Hash, Alloc, N> &B, H h){
+    typedef set_ops<Set<T, Eql, Hash, Alloc, N> > ops;
+    std::vector<bool> in_b, in_a;
+    ops::membership(A, B, h, in_b, in_a);
+    return ops::symmetric(A, B, in_b, in_a);
 }
 
 
-#endif
\ No newline at end of file
+#endif
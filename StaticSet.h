@@ -0,0 +1,164 @@
+#ifndef STATIC_SET_H
+#define STATIC_SET_H
+#include <cstddef> // std::size_t
+#include <functional> // std::less
+#include <ostream>
+#include <utility> // std::move
+#include "set_index_out_of_bound.h"
+/**
+ * @brief Classe StaticSet
+ *
+ * Set a capacità fissa costruibile a tempo di compilazione (richiede C++17).
+ * Gli elementi sono salvati in un array interno, ordinati secondo Less e senza
+ * duplicati: ordinamento ed eliminazione dei duplicati avvengono nel
+ * costruttore constexpr, contains è una ricerca binaria constexpr.
+ * Una tabella dichiarata constexpr non costa nulla all'avvio e non usa heap.
+ * Per le stringhe si usa std::string_view, che a differenza di std::string
+ * è un tipo letterale:
+ *
+ *     constexpr auto regioni = make_static_set<std::string_view>("LAZ", "LOM", "VEN");
+ *     static_assert(regioni.contains("LOM"));
+ *
+ * @tparam T tipo letterale degli elementi, con costruttore di default
+ * @tparam Capacity numero massimo di elementi
+ * @tparam Less funtore di ordinamento constexpr tra due valori di tipo T
+ */
+template<typename T, std::size_t Capacity, typename Less = std::less<T> > class StaticSet{
+    T _values[Capacity == 0 ? 1 : Capacity];///< elementi ordinati
+    std::size_t _size;///< numero di elementi salvati
+    Less _less;///< funtore di ordinamento tra due valori di tipo T
+
+    /**
+     * @brief Inserisce value mantenendo l'array ordinato (insertion sort), se non presente
+     *
+     * @param value valore da inserire
+     */
+    constexpr void insert_sorted(const T &value){
+        std::size_t i = lower_index(value);
+        if (i < _size && !_less(value, _values[i]))
+            return;
+        if (_size == Capacity)
+            throw set_index_out_of_bound("StaticSet capacity exceeded");
+        for (std::size_t j = _size; j > i; --j)
+            _values[j] = std::move(_values[j - 1]);
+        _values[i] = value;
+        _size++;
+    }
+    /**
+     * @brief Indice del primo elemento non minore di value (ricerca binaria)
+     */
+    constexpr std::size_t lower_index(const T &value) const{
+        std::size_t lo = 0, hi = _size;
+        while (lo < hi){
+            std::size_t mid = lo + (hi - lo) / 2;
+            if (_less(_values[mid], value))
+                lo = mid + 1;
+            else
+                hi = mid;
+        }
+        return lo;
+    }
+
+public:
+    typedef const T* const_iterator;///< gli elementi sono contigui: l'iteratore è un puntatore
+
+    /**
+     * @brief Costruttore di default
+     *
+     * @post size() == 0
+     */
+    constexpr StaticSet() : _values(), _size(0), _less() {}
+
+    /**
+     * @brief Costruttore secondario, inserisce i valori passati ignorando i duplicati
+     *
+     * In un contesto constexpr il superamento della capacità è un errore di compilazione
+     *
+     * @tparam Args tipi convertibili in T
+     * @param args valori da inserire
+     * @throw set_index_out_of_bound se i valori distinti superano Capacity
+     */
+    template<typename... Args>
+    constexpr explicit StaticSet(const Args&... args) : _values(), _size(0), _less(){
+        const T values[] = {T(args)...};
+        for (std::size_t i = 0; i < sizeof...(Args); ++i)
+            insert_sorted(values[i]);
+    }
+    /**
+     * @brief Numero degli elementi salvati
+     *
+     * @return numero di elementi
+     */
+    constexpr std::size_t size() const{
+        return _size;
+    }
+    /**
+     * @brief Verifica che il set sia vuoto
+     *
+     * @return true se il set è vuoto
+     */
+    constexpr bool isEmpty() const{
+        return _size == 0;
+    }
+    /**
+     * @brief Verifica se il valore passato è contenuto nel set, in O(log n)
+     *
+     * @param value valore da cercare
+     * @return true se il valore è presente
+     * @return false se il valore non è presente
+     */
+    constexpr bool contains(const T &value) const{
+        std::size_t i = lower_index(value);
+        return i < _size && !_less(value, _values[i]);
+    }
+    /**
+     * @brief Ritorna l'i-esimo valore in ordine crescente
+     *
+     * @param index indice del valore
+     * @return const T& reference del valore ritornato
+     * @throw set_index_out_of_bound eccezione indice fuori range
+     */
+    constexpr const T& operator[](std::size_t index) const{
+        if (index >= _size)
+            throw set_index_out_of_bound("Cannot read the value with an index out of bound");
+        return _values[index];
+    }
+    /**
+     * @brief Iteratore al più piccolo elemento
+     */
+    constexpr const_iterator begin() const{
+        return _values;
+    }
+    /**
+     * @brief Iteratore di fine
+     */
+    constexpr const_iterator end() const{
+        return _values + _size;
+    }
+    /**
+     * @brief Operatore di stream
+     * @param os stream di output
+     * @param s set da spedire sullo stream
+     * @return reference dello stream di output
+     */
+    friend std::ostream& operator<<(std::ostream &os, const StaticSet &s){
+        for (const_iterator b = s.begin(); b != s.end(); ++b)
+            os<<*b<<" ";
+        return os;
+    }
+};
+
+/**
+ * @brief Costruisce uno StaticSet con capacità pari al numero di valori
+ *
+ * @tparam T tipo degli elementi
+ * @tparam Args tipi convertibili in T
+ * @param args valori da inserire, i duplicati vengono ignorati
+ * @return StaticSet<T, sizeof...(Args)> set ordinato dei valori distinti
+ */
+template<typename T, typename... Args>
+constexpr StaticSet<T, sizeof...(Args)> make_static_set(const Args&... args){
+    return StaticSet<T, sizeof...(Args)>(args...);
+}
+
+#endif
@@ -0,0 +1,554 @@
+#ifndef VECTOR_SET_H
+#define VECTOR_SET_H
+#include <algorithm>
+#include <iostream>
+#include <ostream>
+#include <new> // ::operator new, placement new
+#include <utility> // std::move, std::move_if_noexcept
+#include <iterator> // std::random_access_iterator_tag
+#include <cstddef> // std::ptrdiff_t
+#include <type_traits> // std::integral_constant, std::is_arithmetic
+#include "set_index_out_of_bound.h"
+#include "simd_find.h"
+/**
+ * @brief Classe VectorSet
+ * 
+ * La classe implementa un generico set in cui ogni elemento compare
+ * una e una sola volta, con la stessa interfaccia di Set.
+ * Gli elementi sono memorizzati in un unico array contiguo nell'ordine di
+ * inserimento: le scansioni di contains, operator== e operator<< sono lineari
+ * in memoria, operator[] è O(1) e const_iterator è ad accesso casuale.
+ * Se T è un tipo aritmetico e is_plain_equality<Eql, T> è vero, la ricerca
+ * usa i kernel SIMD di simd_find.h
+ * 
+ * @tparam T tipo degli elementi
+ * @tparam Eql funtore di uguaglianza tra due valori di tipo T
+ */
+template<typename T, typename Eql> class VectorSet{
+    T *_data;///< array degli elementi, i primi _size sono costruiti
+    unsigned int _size;///< numero di elementi salvati
+    unsigned int _capacity;///< numero di elementi allocati
+    Eql _equals;///< funtore di uguaglianza tra due valori di tipo T
+
+    static const unsigned int _min_capacity = 8;///< capacità della prima allocazione
+
+    /**
+     * @brief true se la ricerca può essere vettorizzata
+     */
+    typedef std::integral_constant<bool, std::is_arithmetic<T>::value && is_plain_equality<Eql, T>::value> simd_search;
+
+    /**
+     * @brief Cerca la posizione del valore passato
+     * 
+     * @param value valore da cercare
+     * @return indice dell'elemento, _size se il valore non è presente
+     */
+    unsigned int find_index(const T &value) const{
+        return find_index(value, simd_search());
+    }
+    /**
+     * @brief Ricerca lineare tramite il funtore Eql
+     */
+    unsigned int find_index(const T &value, std::false_type) const{
+        for (unsigned int i = 0; i < _size; ++i)
+            if (_equals(_data[i], value))
+                return i;
+        return _size;
+    }
+    /**
+     * @brief Ricerca vettorizzata per tipi aritmetici con uguaglianza semplice
+     */
+    unsigned int find_index(const T &value, std::true_type) const{
+        return simd_find(_data, _size, value);
+    }
+    /**
+     * @brief Rialloca l'array con la capacità indicata spostando gli elementi
+     * 
+     * @param capacity nuova capacità, maggiore o uguale a _size
+     * @throw std::bad_alloc possibile eccezione di allocazione, in tal caso il set non viene alterato
+     */
+    void reallocate(unsigned int capacity){
+        T *data = static_cast<T*>(::operator new(sizeof(T) * capacity));
+        unsigned int i = 0;
+        try{
+            for (; i < _size; ++i)
+                new (data + i) T(std::move_if_noexcept(_data[i]));
+        }catch(...){
+            destroy(data, i);
+            ::operator delete(data);
+            throw;
+        }
+        destroy(_data, _size);
+        ::operator delete(_data);
+        _data = data;
+        _capacity = capacity;
+    }
+    /**
+     * @brief Distrugge i primi n elementi di un array
+     * 
+     * @param data array
+     * @param n numero di elementi costruiti
+     */
+    static void destroy(T *data, unsigned int n){
+        for (unsigned int i = 0; i < n; ++i)
+            data[i].~T();
+    }
+    /**
+     * @brief Garantisce spazio per almeno un nuovo elemento, raddoppiando la capacità
+     * 
+     * @throw std::bad_alloc possibile eccezione di allocazione
+     */
+    void grow(){
+        if (_size < _capacity)
+            return;
+        reallocate(_capacity == 0 ? _min_capacity : _capacity * 2);
+    }
+
+public:
+    /**
+     * @brief Costruttore di default
+     * 
+     * @post _data == nullptr
+     * @post _size == 0
+     */
+    VectorSet() : _data(nullptr), _size(0), _capacity(0) {}
+
+    /**
+     * @brief Copy constructor
+     * 
+     * @param other set da copiare
+     * @post _size == other._size
+     * 
+     * @throw std::bad_alloc eccezione durante l'allocazione dell'array
+     */
+    VectorSet(const VectorSet &other) : _data(nullptr), _size(0), _capacity(0){
+        if (other._size == 0)
+            return;
+        _data = static_cast<T*>(::operator new(sizeof(T) * other._size));
+        _capacity = other._size;
+        try{
+            for (; _size < other._size; ++_size)
+                new (_data + _size) T(other._data[_size]);
+        }catch(...){
+            clear();
+            throw;
+        }
+    }
+    /**
+     * @brief Operatore assegnamento
+     * 
+     * @param other set da copiare
+     * @return reference al set this
+     * 
+     * @post _size == other._size
+     */
+    VectorSet& operator=(const VectorSet &other){
+        if (this != &other){
+            VectorSet tmp(other);
+            std::swap(_data, tmp._data);
+            std::swap(_size, tmp._size);
+            std::swap(_capacity, tmp._capacity);
+        }
+        return *this;
+    }
+    /**
+     * @brief Distruttore
+     * @post _data == nullptr
+     * @post _size == 0
+     */
+    ~VectorSet(){
+        clear();
+    }
+
+    /**
+     * @brief Costruttore secondario, costruisce un set a partire da due iteratori sul tipo Q
+     * 
+     * @tparam Q tipo dell'iteratore
+     * @param b iteratore di inizio
+     * @param e iteratore di fine
+     */
+    template<typename Q> VectorSet(Q b, Q e) : _data(nullptr), _size(0), _capacity(0){
+        try{
+            for(; b!=e; ++b)
+                add(static_cast<T>(*b));
+        }catch(...){
+            clear();
+            throw;
+        }
+    }
+    /**
+     * @brief Aggiunge un nuovo valore in coda solo se quest'ultimo non
+     * è presente
+     * 
+     * @param value valore da memorizzare
+     * @throw std::bad_alloc possibile eccezione di allocazione
+     */
+    void add(const T &value){
+        if (find_index(value) != _size)
+            return;
+        if (_size == _capacity){
+            T copy(value); //value potrebbe appartenere all'array che viene riallocato
+            grow();
+            new (_data + _size) T(std::move(copy));
+        }else{
+            new (_data + _size) T(value);
+        }
+        _size++;
+    }
+    /**
+     * @brief Rimuove il valore passato come parametro solo se è presente,
+     * spostando indietro gli elementi successivi per preservare l'ordine di inserimento
+     * 
+     * @param value valore da rimuovere
+     */
+    void remove(const T &value){
+        unsigned int i = find_index(value);
+        if (i == _size)
+            return;
+        for (; i + 1 < _size; ++i)
+            _data[i] = std::move(_data[i + 1]);
+        _data[_size - 1].~T();
+        _size--;
+    }
+    /**
+     * @brief Svuota il set e libera l'array
+     * @post _data == nullptr
+     * @post _size == 0
+     */
+    void clear(){
+        destroy(_data, _size);
+        ::operator delete(_data);
+        _data = nullptr;
+        _size = 0;
+        _capacity = 0;
+    }
+    /**
+     * @brief Ritorna il numero degli elementi salvati
+     * 
+     * @return copia del valore degli elementi salvati
+     */
+    unsigned int size() const{
+        return _size;
+    }
+    /**
+     * @brief Verifica che il set sia vuoto
+     * 
+     * @return true se il set è vuoto
+     * @return false se il set non è vuoto
+     */
+    bool isEmpty() const{
+        return _size == 0;
+    }
+    /**
+     * @brief Verifica se il valore passato come parametro è contenuto nel set
+     * 
+     * @param value valore da cercare
+     * @return true se il valore è presente
+     * @return false se il valore non è presente
+     */
+    bool contains(const T &value) const{
+        return find_index(value) != _size;
+    }
+    /**
+     * @brief Ritorna l'i-esimo valore del set in O(1)
+     * 
+     * @param index indice del valore
+     * @return const T& reference del valore ritornato
+     * 
+     * @throw set_index_out_of_bound eccezione indice fuori range
+     */
+    const T& operator[](int index) const{
+        if (index < 0 || static_cast<unsigned int>(index) >= _size)
+            throw set_index_out_of_bound("Cannot read the value with an index out of bound");
+        return _data[index];
+    }
+    /**
+     * @brief Operatore == che verifica che due set sono uguali, cioè contengono gli stessi elementi
+     * 
+     * @param other set con cui fare il confronto
+     * @return true se il set this contiene gli stessi dati di other, o se entrambi sono vuoti
+     * @return false altrimenti
+     */
+    bool operator==(const VectorSet &other) const{
+        if (_size != other._size)
+            return false;
+        for (unsigned int i = 0; i < other._size; ++i)
+            if (!contains(other._data[i]))
+                return false;
+        return true;
+    }
+    /**
+     * @brief Operatore di stream
+     * @param os stream di output
+     * @param s set da spedire sullo stream
+     * @return reference dello stream di output
+     */
+    friend std::ostream& operator<<(std::ostream &os, const VectorSet &s){
+        for (unsigned int i = 0; i < s._size; ++i)
+            os<<s._data[i]<<" ";
+        return os;
+    }
+
+    /**
+     * Classe const_iterator
+     * Iteratore ad accesso casuale sui dati contenuti nel set
+     * @brief Classe const_iterator
+     */
+    class const_iterator {
+
+        public:
+            typedef std::random_access_iterator_tag iterator_category;
+            typedef T                               value_type;
+            typedef ptrdiff_t                       difference_type;
+            typedef const T*                        pointer;
+            typedef const T&                        reference;
+
+            /**
+             * @brief Costruttore di default
+             */
+            const_iterator() : ptr(nullptr) {}
+            /**
+             * @brief Copy constructor
+             * 
+             * @param other iteratore da cui copiare i dati
+             */
+            const_iterator(const const_iterator &other) : ptr(other.ptr) {}
+            /**
+             * @brief Operatore assegnamento
+             * 
+             * @param other iteratore da cui copiare i dati
+             * @return reference all'iteratore this
+             */
+            const_iterator& operator=(const const_iterator &other) {
+                ptr=other.ptr;
+                return *this;
+            }
+            /**
+             * @brief Distruttore
+             */
+            ~const_iterator() {}
+
+            /**
+             * @brief Operatore*
+             * 
+             * @return reference al dato riferito dall'iteratore
+             */
+            reference operator*() const {
+                return *ptr;
+            }
+            /**
+             * @brief Operatore->
+             * 
+             * @return puntatore al dato riferito dall'iteratore
+             */
+            pointer operator->() const {
+                return ptr;
+            }
+            /**
+             * @brief Operatore[]
+             * 
+             * @param n distanza dal dato riferito dall'iteratore
+             * @return reference al dato in posizione n
+             */
+            reference operator[](difference_type n) const {
+                return ptr[n];
+            }
+            /**
+             * @brief Operatore++ di post-incremento
+             * @return copia dell'iteratore che punta al valore precedente
+             */
+            const_iterator operator++(int) {
+                const_iterator tmp(*this);
+                ++ptr;
+                return tmp;
+            }
+            /**
+             * @brief Operatore++ pre-incremento
+             * @return reference all'iteratore this
+             */
+            const_iterator& operator++() {
+                ++ptr;
+                return *this;
+            }
+            /**
+             * @brief Operatore-- di post-decremento
+             * @return copia dell'iteratore che punta al valore successivo
+             */
+            const_iterator operator--(int) {
+                const_iterator tmp(*this);
+                --ptr;
+                return tmp;
+            }
+            /**
+             * @brief Operatore-- pre-decremento
+             * @return reference all'iteratore this
+             */
+            const_iterator& operator--() {
+                --ptr;
+                return *this;
+            }
+            /**
+             * @brief Avanza l'iteratore di n posizioni
+             * @return reference all'iteratore this
+             */
+            const_iterator& operator+=(difference_type n) {
+                ptr+=n;
+                return *this;
+            }
+            /**
+             * @brief Arretra l'iteratore di n posizioni
+             * @return reference all'iteratore this
+             */
+            const_iterator& operator-=(difference_type n) {
+                ptr-=n;
+                return *this;
+            }
+            /**
+             * @brief Iteratore spostato in avanti di n posizioni
+             */
+            const_iterator operator+(difference_type n) const {
+                return const_iterator(ptr+n);
+            }
+            /**
+             * @brief Iteratore spostato indietro di n posizioni
+             */
+            const_iterator operator-(difference_type n) const {
+                return const_iterator(ptr-n);
+            }
+            /**
+             * @brief Distanza tra due iteratori
+             */
+            difference_type operator-(const const_iterator &other) const {
+                return ptr-other.ptr;
+            }
+            /**
+             * @brief Operatore==
+             * 
+             * @return true se l'iteratore this e other puntano allo stesso dato
+             */
+            bool operator==(const const_iterator &other) const {
+                return ptr==other.ptr;
+            }
+            /**
+             * @brief Operatore!=
+             * 
+             * @return true se l'iteratore this e other non puntano allo stesso dato
+             */
+            bool operator!=(const const_iterator &other) const {
+                return !(*this == other);
+            }
+            /**
+             * @brief Operatore<
+             * 
+             * @return true se l'iteratore this precede other
+             */
+            bool operator<(const const_iterator &other) const {
+                return ptr<other.ptr;
+            }
+            /**
+             * @brief Operatore>
+             */
+            bool operator>(const const_iterator &other) const {
+                return other < *this;
+            }
+            /**
+             * @brief Operatore<=
+             */
+            bool operator<=(const const_iterator &other) const {
+                return !(other < *this);
+            }
+            /**
+             * @brief Operatore>=
+             */
+            bool operator>=(const const_iterator &other) const {
+                return !(*this < other);
+            }
+
+        private:
+            friend class VectorSet;///< friend della classe const_iterator
+            const T *ptr;///< elemento riferito dall'iteratore
+
+            /**
+             * @brief Costruttore privato
+             * 
+             * @param p elemento con cui inizializzare il dato membro
+             */
+            const_iterator(const T *p) : ptr(p) {}
+    };
+
+    /**
+     * @brief Iteratore di inizio
+     * 
+     * @return const_iterator
+     */
+    const_iterator begin() const {
+        return const_iterator(_data);
+    }
+    /**
+     * @brief Iteratore di fine
+     * 
+     * @return const_iterator
+     */
+    const_iterator end() const {
+        return const_iterator(_data + _size);
+    }
+};
+/**
+ * @brief Filtra dal set S i valori che soddisfano il predicato P
+ * 
+ * @tparam T tipo dell'oggetto set
+ * @tparam Eql funtore di uguaglianza dell'oggetto set
+ * @tparam P tipo del funtore
+ * @param S oggetto set
+ * @param pred funtore predicato
+ * @return VectorSet<T, Eql> nuovo set che contiene i valori di S che soddisfano il predicato P
+ * @throw std::bad_alloc eccezione nel caso di cattiva allocazione della memoria
+ */
+template<typename T, typename Eql, typename P>
+VectorSet<T, Eql> filter_out(const VectorSet<T, Eql> &S, P pred){
+    VectorSet<T, Eql> filtered_set;
+    typename VectorSet<T, Eql>::const_iterator b, e;
+    for(b=S.begin(),e=S.end(); b!=e; ++b)
+        if(pred(*b))
+            filtered_set.add(*b);
+    return filtered_set;
+}
+/**
+ * @brief Operator+
+ * 
+ * @tparam T tipo dell'oggetto set
+ * @tparam Eql funtore di uguaglianza dell'oggetto set
+ * @param A oggetto set di sinistra
+ * @param B oggetto set di destra
+ * @return VectorSet<T, Eql> nuovo set che contiene i valori presenti in A o B
+ * @throw std::bad_alloc eccezione nel caso di cattiva allocazione della memoria
+ */
+template<typename T, typename Eql>
+VectorSet<T, Eql> operator+(const VectorSet<T, Eql> &A, const VectorSet<T, Eql> &B){
+    VectorSet<T, Eql> union_set(A);
+    typename VectorSet<T, Eql>::const_iterator b, e;
+    for(b=B.begin(),e=B.end(); b!=e; ++b)
+        union_set.add(*b);
+    return union_set;
+}
+/**
+ * @brief Operator-
+ * 
+ * @tparam T tipo dell'oggetto set
+ * @tparam Eql funtore di uguaglianza dell'oggetto set
+ * @param A oggetto set di sinistra
+ * @param B oggetto set di destra
+ * @return VectorSet<T, Eql> nuovo set che contiene i valori presenti in A e B
+ * @throw std::bad_alloc eccezione nel caso di cattiva allocazione della memoria
+ */
+template<typename T, typename Eql>
+VectorSet<T, Eql> operator-(const VectorSet<T, Eql> &A, const VectorSet<T, Eql> &B){
+    VectorSet<T, Eql> intersect_set;
+    typename VectorSet<T, Eql>::const_iterator b, e;
+    for(b=A.begin(),e=A.end(); b!=e; ++b)
+        if(B.contains(*b))
+            intersect_set.add(*b);
+    return intersect_set;
+}
+
+#endif
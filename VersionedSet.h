@@ -0,0 +1,484 @@
+#ifndef VERSIONED_SET_H
+#define VERSIONED_SET_H
+#include <atomic> // std::atomic_load, std::atomic_store su shared_ptr
+#include <iterator> // std::forward_iterator_tag
+#include <memory> // std::shared_ptr
+#include <mutex>
+#include <ostream>
+#include <unordered_map>
+#include <vector>
+#include "Set.h" // no_hash
+
+template<typename T, typename Eql, typename Hash> class VersionedSet;
+
+/**
+ * @brief Classe SetSnapshot
+ *
+ * Versione immutabile di un VersionedSet. Gli elementi sono salvati, in ordine
+ * di inserimento, nelle foglie di un trie persistente con 32 figli per nodo:
+ * ogni nuova versione copia solo i nodi sul cammino dalla radice allo slot
+ * modificato e condivide tutti gli altri con le versioni precedenti.
+ * Copiare uno snapshot costa O(1); lo snapshot non viene mai modificato, quindi
+ * può essere letto e iterato da più thread senza sincronizzazione.
+ * Gli elementi rimossi lasciano uno slot vuoto, saltato dall'iterazione
+ *
+ * @tparam T tipo degli elementi
+ * @tparam Eql funtore di uguaglianza tra due valori di tipo T
+ */
+template<typename T, typename Eql> class SetSnapshot{
+    template<typename, typename, typename> friend class VersionedSet;
+
+    static const unsigned int _bits = 5;///< bit di indice per livello
+    static const unsigned int _width = 1u << _bits;///< figli per nodo
+    static const unsigned int _mask = _width - 1;
+
+    /**
+     * @brief Nodo del trie: i nodi interni usano children, le foglie values
+     */
+    struct node{
+        std::vector<std::shared_ptr<const node> > children;///< figli
+        std::vector<T> values;///< valori della foglia
+        unsigned int alive;///< bit i a 1 se values[i] non è stato rimosso
+
+        node() : alive(0) {}
+    };
+    typedef std::shared_ptr<const node> node_ptr;
+
+    node_ptr _root;///< radice del trie
+    unsigned int _shift;///< bit di indice consumati dai livelli sopra le foglie
+    unsigned int _slots;///< slot occupati, compresi quelli rimossi
+    unsigned int _size;///< numero di elementi salvati
+    Eql _equals;///< funtore di uguaglianza tra due valori di tipo T
+
+    /**
+     * @brief Foglia che contiene uno slot
+     *
+     * @param slot indice dello slot, minore di _slots
+     * @return puntatore alla foglia
+     */
+    const node* leaf_of(unsigned int slot) const{
+        const node *n = _root.get();
+        for (unsigned int s = _shift; s > 0; s -= _bits)
+            n = n->children[(slot >> s) & _mask].get();
+        return n;
+    }
+    /**
+     * @brief Copia il cammino fino allo slot e vi scrive value
+     *
+     * @param n sottoalbero di partenza, nullptr se ancora da creare
+     * @param shift bit di indice consumati sopra le foglie del sottoalbero
+     * @param slot indice dello slot, uguale a _slots
+     * @param value valore da aggiungere
+     * @return nuovo sottoalbero
+     * @throw std::bad_alloc possibile eccezione di allocazione
+     */
+    static node_ptr push(const node_ptr &n, unsigned int shift, unsigned int slot, const T &value){
+        std::shared_ptr<node> copy = n ? std::make_shared<node>(*n) : std::make_shared<node>();
+        if (shift == 0){
+            copy->values.push_back(value);
+            copy->alive |= 1u << (slot & _mask);
+        } else {
+            unsigned int i = (slot >> shift) & _mask;
+            if (i < copy->children.size())
+                copy->children[i] = push(copy->children[i], shift - _bits, slot, value);
+            else
+                copy->children.push_back(push(node_ptr(), shift - _bits, slot, value));
+        }
+        return copy;
+    }
+    /**
+     * @brief Copia il cammino fino allo slot e lo segna come rimosso
+     *
+     * @param n sottoalbero che contiene lo slot
+     * @param shift bit di indice consumati sopra le foglie del sottoalbero
+     * @param slot indice dello slot
+     * @return nuovo sottoalbero
+     * @throw std::bad_alloc possibile eccezione di allocazione
+     */
+    static node_ptr erase(const node_ptr &n, unsigned int shift, unsigned int slot){
+        std::shared_ptr<node> copy = std::make_shared<node>(*n);
+        if (shift == 0)
+            copy->alive &= ~(1u << (slot & _mask));
+        else {
+            unsigned int i = (slot >> shift) & _mask;
+            copy->children[i] = erase(copy->children[i], shift - _bits, slot);
+        }
+        return copy;
+    }
+    /**
+     * @brief Nuova versione con value in coda
+     *
+     * @param value valore da aggiungere, non presente
+     * @return versione aggiornata, this non viene modificato
+     * @throw std::bad_alloc possibile eccezione di allocazione
+     */
+    SetSnapshot pushed(const T &value) const{
+        SetSnapshot next(*this);
+        if (next._root && static_cast<unsigned long long>(next._slots) == (static_cast<unsigned long long>(_width) << next._shift)){
+            //trie pieno: la vecchia radice diventa il primo figlio di una nuova radice
+            std::shared_ptr<node> top = std::make_shared<node>();
+            top->children.push_back(next._root);
+            next._root = top;
+            next._shift += _bits;
+        }
+        next._root = push(next._root, next._shift, next._slots, value);
+        next._slots++;
+        next._size++;
+        return next;
+    }
+    /**
+     * @brief Nuova versione senza l'elemento dello slot
+     *
+     * @param slot indice di uno slot non rimosso
+     * @return versione aggiornata, this non viene modificato
+     * @throw std::bad_alloc possibile eccezione di allocazione
+     */
+    SetSnapshot erased(unsigned int slot) const{
+        SetSnapshot next(*this);
+        next._root = erase(next._root, next._shift, slot);
+        next._size--;
+        return next;
+    }
+
+public:
+    /**
+     * @brief Costruttore di default
+     *
+     * @post size() == 0
+     */
+    SetSnapshot() : _shift(0), _slots(0), _size(0) {}
+
+    /**
+     * @brief Numero degli elementi salvati
+     *
+     * @return numero di elementi
+     */
+    unsigned int size() const{
+        return _size;
+    }
+    /**
+     * @brief Verifica che lo snapshot sia vuoto
+     *
+     * @return true se lo snapshot è vuoto
+     */
+    bool isEmpty() const{
+        return _size == 0;
+    }
+
+    class const_iterator;
+    /**
+     * @brief Verifica se il valore passato è contenuto nello snapshot
+     *
+     * Ricerca lineare: per ricerche frequenti usare VersionedSet::contains
+     *
+     * @param value valore da cercare
+     * @return true se il valore è presente
+     * @return false se il valore non è presente
+     */
+    bool contains(const T &value) const{
+        for (const_iterator b = begin(), e = end(); b != e; ++b)
+            if (_equals(*b, value))
+                return true;
+        return false;
+    }
+
+    /**
+     * @brief Iteratore costante in avanti sugli elementi, in ordine di inserimento
+     *
+     * Resta valido finché esiste lo snapshot da cui è stato ottenuto
+     */
+    class const_iterator{
+        public:
+            typedef std::forward_iterator_tag iterator_category;
+            typedef T                         value_type;
+            typedef ptrdiff_t                 difference_type;
+            typedef const T*                  pointer;
+            typedef const T&                  reference;
+
+            /**
+             * @brief Costruttore di default
+             *
+             */
+            const_iterator() : _set(nullptr), _slot(0), _leaf(nullptr) {}
+
+            /**
+             * @brief Operatore*
+             *
+             * @return reference al dato riferito dall'iteratore (dereferenziamento)
+             */
+            reference operator*() const{
+                return _leaf->values[_slot & _mask];
+            }
+            /**
+             * @brief Operatore->
+             *
+             * @return puntatore al dato riferito dall'iteratore
+             */
+            pointer operator->() const{
+                return &_leaf->values[_slot & _mask];
+            }
+            /**
+             * @brief Operatore++ di post-incremento
+             * @return copia dell'iteratore che punta al valore precedente
+             */
+            const_iterator operator++(int){
+                const_iterator tmp(*this);
+                ++*this;
+                return tmp;
+            }
+            /**
+             * @brief Operatore++ pre-incremento
+             * @return reference all'iteratore this
+             */
+            const_iterator& operator++(){
+                ++_slot;
+                skip_removed();
+                return *this;
+            }
+            /**
+             * @brief Operatore==
+             *
+             * @param other iteratore da confrontare
+             * @return true se i due iteratori puntano allo stesso slot
+             */
+            bool operator==(const const_iterator &other) const{
+                return _set == other._set && _slot == other._slot;
+            }
+            /**
+             * @brief Operatore!=
+             *
+             * @param other iteratore da confrontare
+             * @return true se i due iteratori puntano a slot diversi
+             */
+            bool operator!=(const const_iterator &other) const{
+                return !(*this == other);
+            }
+
+        private:
+            friend class SetSnapshot;
+
+            const SetSnapshot *_set;///< snapshot visitato
+            unsigned int _slot;///< slot corrente
+            const node *_leaf;///< foglia che contiene lo slot corrente
+
+            const_iterator(const SetSnapshot *set, unsigned int slot) : _set(set), _slot(slot), _leaf(nullptr){
+                skip_removed();
+            }
+            /**
+             * @brief Avanza fino al primo slot non rimosso (o alla fine)
+             */
+            void skip_removed(){
+                for (; _slot < _set->_slots; ++_slot){
+                    if (_leaf == nullptr || (_slot & _mask) == 0)
+                        _leaf = _set->leaf_of(_slot);
+                    if ((_leaf->alive >> (_slot & _mask)) & 1u)
+                        return;
+                }
+                _leaf = nullptr;
+            }
+    };
+
+    /**
+     * @brief Iteratore di inizio
+     *
+     * @return iteratore al primo elemento
+     */
+    const_iterator begin() const{
+        return const_iterator(this, 0);
+    }
+    /**
+     * @brief Iteratore di fine
+     *
+     * @return iteratore alla fine della sequenza
+     */
+    const_iterator end() const{
+        return const_iterator(this, _slots);
+    }
+    /**
+     * @brief Operatore di stream
+     * @param os stream di output
+     * @param s snapshot da spedire sullo stream
+     * @return reference dello stream di output
+     */
+    friend std::ostream& operator<<(std::ostream &os, const SetSnapshot &s){
+        for (const_iterator b = s.begin(), e = s.end(); b != e; ++b)
+            os<<*b<<" ";
+        return os;
+    }
+};
+
+/**
+ * @brief Classe VersionedSet
+ *
+ * Set a versioni in stile RCU. Gli scrittori (serializzati da un mutex)
+ * producono ad ogni modifica un nuovo SetSnapshot che condivide con il
+ * precedente tutto tranne il cammino modificato, e lo pubblicano atomicamente.
+ * snapshot() restituisce in O(1) l'ultima versione pubblicata: i lettori la
+ * iterano senza lock mentre gli scrittori continuano a pubblicarne di nuove.
+ * add e remove costano O(log32 n), più la copia di una foglia.
+ *
+ * Per trovare lo slot di un valore gli scrittori mantengono un indice
+ * valore -> slot costruito con Hash ed Eql (con no_hash la ricerca è lineare).
+ * Quando gli slot rimossi superano quelli occupati il trie viene ricompattato
+ *
+ * @tparam T tipo degli elementi
+ * @tparam Eql funtore di uguaglianza tra due valori di tipo T
+ * @tparam Hash funtore hash su T, coerente con Eql
+ */
+template<typename T, typename Eql, typename Hash = no_hash> class VersionedSet{
+    typedef SetSnapshot<T, Eql> snapshot_type;
+
+    mutable std::mutex _mutex;///< serializza gli scrittori
+    snapshot_type _draft;///< versione corrente, vista solo dagli scrittori
+    std::shared_ptr<const snapshot_type> _published;///< ultima versione pubblicata
+    std::unordered_map<T, unsigned int, Hash, Eql> _slot_of;///< slot di ogni valore
+
+    /**
+     * @brief Rende visibile _draft ai lettori
+     *
+     * @throw std::bad_alloc possibile eccezione di allocazione
+     */
+    void publish(){
+        std::atomic_store(&_published, std::shared_ptr<const snapshot_type>(std::make_shared<snapshot_type>(_draft)));
+    }
+    /**
+     * @brief Ricostruisce il trie senza gli slot rimossi
+     *
+     * @throw std::bad_alloc possibile eccezione di allocazione
+     */
+    void compact(){
+        snapshot_type fresh;
+        std::unordered_map<T, unsigned int, Hash, Eql> slots;
+        slots.reserve(_draft.size());
+        for (typename snapshot_type::const_iterator b = _draft.begin(), e = _draft.end(); b != e; ++b){
+            slots.insert(std::make_pair(*b, fresh._slots));
+            fresh = fresh.pushed(*b);
+        }
+        _draft = fresh;
+        _slot_of.swap(slots);
+    }
+
+    VersionedSet(const VersionedSet &);
+    VersionedSet& operator=(const VersionedSet &);
+
+public:
+    /**
+     * @brief Costruttore di default
+     *
+     * @post size() == 0
+     * @throw std::bad_alloc possibile eccezione di allocazione
+     */
+    VersionedSet() : _published(std::make_shared<snapshot_type>()) {}
+
+    /**
+     * @brief Costruttore secondario, costruisce un set a partire da due iteratori sul tipo Q
+     *
+     * @tparam Q tipo dell'iteratore
+     * @param b iteratore di inizio
+     * @param e iteratore di fine
+     * @throw std::bad_alloc possibile eccezione di allocazione
+     */
+    template<typename Q> VersionedSet(Q b, Q e){
+        for(; b!=e; ++b){
+            T value = static_cast<T>(*b);
+            if (_slot_of.find(value) == _slot_of.end()){
+                _slot_of.insert(std::make_pair(value, _draft._slots));
+                _draft = _draft.pushed(value);
+            }
+        }
+        publish();
+    }
+    /**
+     * @brief Aggiunge un valore solo se non è presente e pubblica la nuova versione
+     *
+     * @param value valore da memorizzare
+     * @return true se il valore è stato aggiunto
+     * @throw std::bad_alloc possibile eccezione di allocazione
+     */
+    bool add(const T &value){
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (_slot_of.find(value) != _slot_of.end())
+            return false;
+        snapshot_type next = _draft.pushed(value);
+        _slot_of.insert(std::make_pair(value, _draft._slots));
+        _draft = next;
+        publish();
+        return true;
+    }
+    /**
+     * @brief Rimuove il valore passato solo se è presente e pubblica la nuova versione
+     *
+     * @param value valore da rimuovere
+     * @return true se il valore è stato rimosso
+     * @throw std::bad_alloc possibile eccezione di allocazione
+     */
+    bool remove(const T &value){
+        std::lock_guard<std::mutex> lock(_mutex);
+        typename std::unordered_map<T, unsigned int, Hash, Eql>::iterator it = _slot_of.find(value);
+        if (it == _slot_of.end())
+            return false;
+        _draft = _draft.erased(it->second);
+        _slot_of.erase(it);
+        if (_draft._slots > snapshot_type::_width && _draft._slots > 2 * _draft._size)
+            compact();
+        publish();
+        return true;
+    }
+    /**
+     * @brief Verifica se il valore passato è contenuto nella versione corrente
+     *
+     * @param value valore da cercare
+     * @return true se il valore è presente
+     * @return false se il valore non è presente
+     */
+    bool contains(const T &value) const{
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _slot_of.find(value) != _slot_of.end();
+    }
+    /**
+     * @brief Numero degli elementi dell'ultima versione pubblicata
+     *
+     * @return numero di elementi
+     */
+    unsigned int size() const{
+        return std::atomic_load(&_published)->size();
+    }
+    /**
+     * @brief Verifica che l'ultima versione pubblicata sia vuota
+     *
+     * @return true se il set è vuoto
+     */
+    bool isEmpty() const{
+        return size() == 0;
+    }
+    /**
+     * @brief Svuota il set pubblicando una versione vuota
+     *
+     * Gli snapshot già ottenuti restano invariati
+     */
+    void clear(){
+        std::lock_guard<std::mutex> lock(_mutex);
+        _draft = snapshot_type();
+        _slot_of.clear();
+        publish();
+    }
+    /**
+     * @brief Ultima versione pubblicata, in O(1)
+     *
+     * @return snapshot immutabile, iterabile senza lock
+     */
+    snapshot_type snapshot() const{
+        return *std::atomic_load(&_published);
+    }
+    /**
+     * @brief Operatore di stream, stampa l'ultima versione pubblicata
+     * @param os stream di output
+     * @param s set da spedire sullo stream
+     * @return reference dello stream di output
+     */
+    friend std::ostream& operator<<(std::ostream &os, const VersionedSet &s){
+        return os<<s.snapshot();
+    }
+};
+
+#endif
@@ -0,0 +1,419 @@
+/**
+ * @file benchmark.cpp
+ * @brief Misure di prestazioni delle operazioni su Set
+ *
+ * Per ogni tipo di elemento (int, std::string, point, Auto) e per dimensioni
+ * da 10 a --max (potenze di 10) misura add, contains (presenti e assenti),
+ * iterazione, operator[], remove, operator+ e filter_out, riportando nanosecondi per
+ * operazione, allocazioni per operazione e picco di memoria heap della misura:
+ * i byte vivi in più rispetto all'inizio della misura, contati dagli operator
+ * new/delete sostituiti (preparazione delle ripetizioni compresa).
+ *
+ * Uso: ./benchmark.exe [--json] [--max=N] [--min-time=MS] [--filter=TESTO]
+ *   --json        stampa i risultati in JSON invece che in tabella
+ *   --max=N       dimensione massima (default 1000000, 10000000 per la sweep completa)
+ *   --min-time=MS durata minima di ogni misura in millisecondi (default 100)
+ *   --filter=TESTO esegue solo le misure il cui nome contiene TESTO
+ *
+ * I set senza indice hash hanno add e contains lineari: per loro la dimensione
+ * è limitata a 10000. index legge tutti gli elementi con operator[] a cache già
+ * estesa: la differenza con iterate è il costo del mutex della cache, preso a
+ * ogni chiamata. Le misure concurrent_int (add e contains su
+ * ConcurrentSet da un solo thread) vanno confrontate con int/add e
+ * int/contains_hit: una partizione che crea cluster nelle tabelle interne le
+ * rende molte volte più lente
+ */
+#include "Set.h"
+#include "ConcurrentSet.h"
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <new>
+#include <string>
+#include <vector>
+#include <malloc.h> // malloc_usable_size
+
+static std::atomic<unsigned long long> allocations(0);///< chiamate a operator new dall'avvio
+static std::atomic<long long> live_bytes(0);///< byte heap vivi allocati con operator new
+static std::atomic<long long> peak_bytes(0);///< massimo di live_bytes dall'ultimo reset_peak
+
+/**
+ * @brief Alloca per tutte le forme di operator new e aggiorna i contatori
+ *
+ * @param size byte richiesti
+ * @param alignment allineamento richiesto, 0 per quello di malloc
+ * @return memoria allocata, nullptr se l'allocazione fallisce
+ */
+static void* counted_alloc(std::size_t size, std::size_t alignment){
+    if (size == 0)
+        size = 1;
+    void *p = alignment == 0 ? std::malloc(size) : std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment);
+    if (p == nullptr)
+        return nullptr;
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    long long bytes = static_cast<long long>(malloc_usable_size(p));
+    long long live = live_bytes.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+    long long peak = peak_bytes.load(std::memory_order_relaxed);
+    while (live > peak && !peak_bytes.compare_exchange_weak(peak, live, std::memory_order_relaxed)) {}
+    return p;
+}
+/**
+ * @brief Rilascia per tutte le forme di operator delete e aggiorna i contatori
+ *
+ * Non inline: il compilatore non deve vedere free applicata al risultato di operator new
+ */
+__attribute__((noinline)) static void counted_free(void *p){
+    if (p == nullptr)
+        return;
+    live_bytes.fetch_sub(static_cast<long long>(malloc_usable_size(p)), std::memory_order_relaxed);
+    std::free(p);
+}
+static void* counted_alloc_or_throw(std::size_t size, std::size_t alignment){
+    if (void *p = counted_alloc(size, alignment))
+        return p;
+    throw std::bad_alloc();
+}
+
+void* operator new(std::size_t size){ return counted_alloc_or_throw(size, 0); }
+void* operator new[](std::size_t size){ return counted_alloc_or_throw(size, 0); }
+void* operator new(std::size_t size, const std::nothrow_t &) noexcept{ return counted_alloc(size, 0); }
+void* operator new[](std::size_t size, const std::nothrow_t &) noexcept{ return counted_alloc(size, 0); }
+void* operator new(std::size_t size, std::align_val_t a){ return counted_alloc_or_throw(size, static_cast<std::size_t>(a)); }
+void* operator new[](std::size_t size, std::align_val_t a){ return counted_alloc_or_throw(size, static_cast<std::size_t>(a)); }
+void* operator new(std::size_t size, std::align_val_t a, const std::nothrow_t &) noexcept{ return counted_alloc(size, static_cast<std::size_t>(a)); }
+void* operator new[](std::size_t size, std::align_val_t a, const std::nothrow_t &) noexcept{ return counted_alloc(size, static_cast<std::size_t>(a)); }
+
+void operator delete(void *p) noexcept{ counted_free(p); }
+void operator delete[](void *p) noexcept{ counted_free(p); }
+void operator delete(void *p, const std::nothrow_t &) noexcept{ counted_free(p); }
+void operator delete[](void *p, const std::nothrow_t &) noexcept{ counted_free(p); }
+void operator delete(void *p, std::size_t) noexcept{ counted_free(p); }
+void operator delete[](void *p, std::size_t) noexcept{ counted_free(p); }
+void operator delete(void *p, std::align_val_t) noexcept{ counted_free(p); }
+void operator delete[](void *p, std::align_val_t) noexcept{ counted_free(p); }
+void operator delete(void *p, std::align_val_t, const std::nothrow_t &) noexcept{ counted_free(p); }
+void operator delete[](void *p, std::align_val_t, const std::nothrow_t &) noexcept{ counted_free(p); }
+void operator delete(void *p, std::size_t, std::align_val_t) noexcept{ counted_free(p); }
+void operator delete[](void *p, std::size_t, std::align_val_t) noexcept{ counted_free(p); }
+
+/**
+ * @brief Punto del piano, come quello dei test
+ */
+struct point{
+    int x;///< coordinata x
+    int y;///< coordinata y
+
+    point() : x(), y() {}
+    point(int i, int j) : x(i), y(j) {}
+};
+struct equals_point{
+    bool operator()(const point &a, const point &b) const{
+        return a.x==b.x && a.y==b.y;
+    }
+};
+struct hash_point{
+    std::size_t operator()(const point &p) const{
+        return std::hash<int>()(p.x) * 31 + std::hash<int>()(p.y);
+    }
+};
+
+/**
+ * @brief Auto identificata dalla targa, come Concessionaria::Auto dei test
+ */
+struct Auto{
+    std::string targa;///< targa dell'auto
+    std::string modello;///< modello dell'auto
+
+    Auto() {}
+    Auto(const std::string &t, const std::string &m) : targa(t), modello(m) {}
+};
+struct equals_auto{
+    bool operator()(const Auto &a, const Auto &b) const{
+        return a.targa==b.targa;
+    }
+};
+struct hash_auto{
+    std::size_t operator()(const Auto &a) const{
+        return std::hash<std::string>()(a.targa);
+    }
+};
+
+struct equals_int{
+    bool operator()(int a, int b) const{
+        return a==b;
+    }
+};
+struct equals_string{
+    bool operator()(const std::string &a, const std::string &b) const{
+        return a==b;
+    }
+};
+
+/**
+ * @brief i-esimo valore distinto di ogni tipo
+ */
+void make_value(unsigned int i, int &v){ v = static_cast<int>(i); }
+void make_value(unsigned int i, std::string &v){ v = "elemento-" + std::to_string(i); }
+void make_value(unsigned int i, point &v){ v = point(static_cast<int>(i), -static_cast<int>(i % 1000)); }
+void make_value(unsigned int i, Auto &v){ v = Auto("AA" + std::to_string(i), "modello " + std::to_string(i % 20)); }
+
+/**
+ * @brief Predicato di filter_out: mantiene circa metà degli elementi
+ */
+bool keep(int v){ return v % 2 == 0; }
+bool keep(const std::string &v){ return (v[v.size() - 1] - '0') % 2 == 0; }
+bool keep(const point &p){ return p.x % 2 == 0; }
+bool keep(const Auto &a){ return (a.targa[a.targa.size() - 1] - '0') % 2 == 0; }
+
+/**
+ * @brief Risultato di una misura
+ */
+struct result{
+    std::string name;///< tipo/operazione
+    unsigned int n;///< dimensione del set
+    unsigned long long iterations;///< ripetizioni eseguite
+    double ns_per_op;///< nanosecondi per operazione
+    double allocs_per_op;///< allocazioni per operazione
+    long long peak_kb;///< picco di memoria heap della misura oltre quella già viva all'inizio (KiB)
+};
+
+/**
+ * @brief Tratto misurato di una ripetizione: la preparazione resta fuori
+ */
+struct section{
+    std::chrono::steady_clock::time_point start;
+    unsigned long long allocs_start;
+    double ns;///< nanosecondi accumulati
+    unsigned long long allocs;///< allocazioni accumulate
+
+    section() : allocs_start(0), ns(0), allocs(0) {}
+    void begin(){
+        allocs_start = allocations.load(std::memory_order_relaxed);
+        start = std::chrono::steady_clock::now();
+    }
+    void end(){
+        std::chrono::steady_clock::time_point stop = std::chrono::steady_clock::now();
+        ns += std::chrono::duration<double, std::nano>(stop - start).count();
+        allocs += allocations.load(std::memory_order_relaxed) - allocs_start;
+    }
+};
+
+/**
+ * @brief Opzioni da riga di comando
+ */
+struct options{
+    bool json;
+    unsigned int max;
+    double min_ns;
+    std::string filter;
+
+    options() : json(false), max(1000000), min_ns(100e6) {}
+};
+
+static volatile std::size_t sink;///< impedisce al compilatore di eliminare i risultati
+
+/**
+ * @brief Riparte dal livello attuale di memoria viva per misurare il picco di una misura
+ *
+ * @return byte vivi al momento del reset
+ */
+long long reset_peak(){
+    long long live = live_bytes.load(std::memory_order_relaxed);
+    peak_bytes.store(live, std::memory_order_relaxed);
+    return live;
+}
+
+/**
+ * @brief Ripete body finché il tempo misurato non supera la durata minima
+ *
+ * @param body funtore (section&) che esegue una ripetizione e delimita il tratto misurato
+ * @param ops operazioni per ripetizione
+ */
+template<typename F>
+void measure(const options &opt, std::vector<result> &results, const std::string &name, unsigned int n, unsigned long long ops, F body){
+    if (!opt.filter.empty() && name.find(opt.filter) == std::string::npos)
+        return;
+    section s;
+    long long baseline = reset_peak();
+    unsigned long long iterations = 0;
+    do{
+        body(s);
+        iterations++;
+    }while (s.ns < opt.min_ns);
+    result r;
+    r.name = name;
+    r.n = n;
+    r.iterations = iterations;
+    r.ns_per_op = s.ns / (iterations * ops);
+    r.allocs_per_op = static_cast<double>(s.allocs) / (iterations * ops);
+    r.peak_kb = (peak_bytes.load(std::memory_order_relaxed) - baseline) / 1024;
+    results.push_back(r);
+    if (!opt.json)
+        std::cout<<name<<"/"<<n<<"\t"<<r.ns_per_op<<" ns/op\t"<<r.allocs_per_op<<" allocs/op\t"<<r.peak_kb<<" KiB picco heap\t("<<iterations<<" ripetizioni)"<<std::endl;
+}
+
+/**
+ * @brief Tutte le misure per un tipo di set e una dimensione
+ *
+ * @tparam S tipo del set
+ * @param label nome del tipo
+ * @param n numero di elementi
+ */
+template<typename S, typename T>
+void bench_set(const options &opt, std::vector<result> &results, const std::string &label, unsigned int n){
+    std::vector<T> values(2 * n);
+    for (unsigned int i = 0; i < 2 * n; ++i)
+        make_value(i, values[i]);
+
+    measure(opt, results, label + "/add", n, n, [&](section &s){
+        s.begin();
+        S set;
+        for (unsigned int i = 0; i < n; ++i)
+            set.add(values[i]);
+        sink = set.size();
+        s.end();
+    });
+    S full;
+    for (unsigned int i = 0; i < n; ++i)
+        full.add(values[i]);
+    measure(opt, results, label + "/contains_hit", n, n, [&](section &s){
+        std::size_t found = 0;
+        s.begin();
+        for (unsigned int i = 0; i < n; ++i)
+            found += full.contains(values[i]);
+        s.end();
+        sink = found;
+    });
+    measure(opt, results, label + "/contains_miss", n, n, [&](section &s){
+        std::size_t found = 0;
+        s.begin();
+        for (unsigned int i = n; i < 2 * n; ++i)
+            found += full.contains(values[i]);
+        s.end();
+        sink = found;
+    });
+    measure(opt, results, label + "/iterate", n, n, [&](section &s){
+        std::size_t count = 0;
+        s.begin();
+        for (typename S::const_iterator b = full.begin(), e = full.end(); b != e; ++b)
+            count += reinterpret_cast<std::size_t>(&*b) & 1;
+        s.end();
+        sink = count;
+    });
+    sink = reinterpret_cast<std::size_t>(&full[static_cast<int>(n - 1)]); //estende la cache: index misura solo gli accessi
+    measure(opt, results, label + "/index", n, n, [&](section &s){
+        std::size_t count = 0;
+        s.begin();
+        for (unsigned int i = 0; i < n; ++i)
+            count += reinterpret_cast<std::size_t>(&full[static_cast<int>(i)]) & 1;
+        s.end();
+        sink = count;
+    });
+    measure(opt, results, label + "/remove", n, n, [&](section &s){
+        S copy(full);
+        s.begin();
+        for (unsigned int i = 0; i < n; ++i)
+            copy.remove(values[i]);
+        s.end();
+        sink = copy.size();
+    });
+    S shifted;
+    for (unsigned int i = n / 2; i < n + n / 2; ++i)
+        shifted.add(values[i]);
+    measure(opt, results, label + "/operator+", n, 2ULL * n, [&](section &s){
+        s.begin();
+        S u = full + shifted;
+        s.end();
+        sink = u.size();
+    });
+    measure(opt, results, label + "/filter_out", n, n, [&](section &s){
+        s.begin();
+        S f = filter_out(full, [](const T &v){ return keep(v); });
+        s.end();
+        sink = f.size();
+    });
+}
+
+/**
+ * @brief add e contains su ConcurrentSet, da confrontare con quelle del Set semplice
+ *
+ * @param n numero di elementi
+ */
+void bench_concurrent(const options &opt, std::vector<result> &results, unsigned int n){
+    typedef ConcurrentSet<int, equals_int, std::hash<int> > S;
+    measure(opt, results, "concurrent_int/add", n, n, [&](section &s){
+        s.begin();
+        S set;
+        for (unsigned int i = 0; i < n; ++i)
+            set.add(static_cast<int>(i));
+        sink = set.size();
+        s.end();
+    });
+    S full;
+    for (unsigned int i = 0; i < n; ++i)
+        full.add(static_cast<int>(i));
+    measure(opt, results, "concurrent_int/contains_hit", n, n, [&](section &s){
+        std::size_t found = 0;
+        s.begin();
+        for (unsigned int i = 0; i < n; ++i)
+            found += full.contains(static_cast<int>(i));
+        s.end();
+        sink = found;
+    });
+}
+
+/**
+ * @brief Dimensioni da 10 a max, potenze di 10
+ */
+template<typename S, typename T>
+void sweep(const options &opt, std::vector<result> &results, const std::string &label, unsigned int max){
+    for (unsigned long long n = 10; n <= max; n *= 10)
+        bench_set<S, T>(opt, results, label, static_cast<unsigned int>(n));
+}
+
+void print_json(const std::vector<result> &results){
+    std::cout<<"{\n  \"benchmarks\": [\n";
+    for (std::size_t i = 0; i < results.size(); ++i){
+        const result &r = results[i];
+        std::cout<<"    {\"name\": \""<<r.name<<"\", \"n\": "<<r.n<<", \"iterations\": "<<r.iterations
+                 <<", \"ns_per_op\": "<<r.ns_per_op<<", \"allocs_per_op\": "<<r.allocs_per_op
+                 <<", \"peak_heap_kb\": "<<r.peak_kb<<"}"<<(i + 1 < results.size() ? "," : "")<<"\n";
+    }
+    std::cout<<"  ]\n}"<<std::endl;
+}
+
+int main(int argc, char **argv){
+    options opt;
+    for (int i = 1; i < argc; ++i){
+        if (std::strcmp(argv[i], "--json") == 0)
+            opt.json = true;
+        else if (std::strncmp(argv[i], "--max=", 6) == 0)
+            opt.max = static_cast<unsigned int>(std::strtoul(argv[i] + 6, nullptr, 10));
+        else if (std::strncmp(argv[i], "--min-time=", 11) == 0)
+            opt.min_ns = std::strtod(argv[i] + 11, nullptr) * 1e6;
+        else if (std::strncmp(argv[i], "--filter=", 9) == 0)
+            opt.filter = argv[i] + 9;
+        else{
+            std::cerr<<"uso: "<<argv[0]<<" [--json] [--max=N] [--min-time=MS] [--filter=TESTO]"<<std::endl;
+            return 1;
+        }
+    }
+    const unsigned int linear_max = opt.max < 10000 ? opt.max : 10000;
+
+    std::vector<result> results;
+    sweep<Set<int, equals_int, std::hash<int> >, int>(opt, results, "int", opt.max);
+    sweep<Set<std::string, equals_string, std::hash<std::string> >, std::string>(opt, results, "string", opt.max);
+    sweep<Set<point, equals_point, hash_point>, point>(opt, results, "point", opt.max);
+    sweep<Set<Auto, equals_auto, hash_auto>, Auto>(opt, results, "Auto", opt.max);
+    sweep<Set<int, equals_int>, int>(opt, results, "int_no_hash", linear_max);
+    sweep<Set<point, equals_point>, point>(opt, results, "point_no_hash", linear_max);
+    for (unsigned long long n = 10; n <= opt.max; n *= 10)
+        bench_concurrent(opt, results, static_cast<unsigned int>(n));
+
+    if (opt.json)
+        print_json(results);
+    return 0;
+}
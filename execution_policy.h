@@ -0,0 +1,94 @@
+#ifndef EXECUTION_POLICY_H
+#define EXECUTION_POLICY_H
+#include <thread>
+#include <vector>
+#include <exception> // std::exception_ptr
+/**
+ * @brief Politiche di esecuzione per gli algoritmi sui set
+ * 
+ * Ricalcano std::execution senza dipendere da una libreria esterna di thread:
+ * seq esegue l'algoritmo nel thread chiamante, par divide il set in blocchi
+ * contigui valutati da più thread, par_unseq si comporta come par
+ */
+namespace execution{
+    /**
+     * @brief Esecuzione sequenziale nel thread chiamante
+     */
+    struct sequenced_policy{};
+    /**
+     * @brief Esecuzione parallela su più thread
+     */
+    struct parallel_policy{};
+    /**
+     * @brief Esecuzione parallela e non sequenziata (trattata come parallel_policy)
+     */
+    struct parallel_unsequenced_policy : parallel_policy{};
+
+    static const sequenced_policy seq = sequenced_policy();
+    static const parallel_policy par = parallel_policy();
+    static const parallel_unsequenced_policy par_unseq = parallel_unsequenced_policy();
+
+    /**
+     * @brief Numero minimo di elementi per thread: sotto questa soglia
+     * il costo di creazione del thread supera il guadagno
+     */
+    static const unsigned int min_chunk = 256;
+
+    /**
+     * @brief Numero di thread da usare per n elementi
+     * 
+     * @param n numero di elementi da elaborare
+     * @return numero di thread, almeno 1
+     */
+    inline unsigned int worker_count(unsigned int n){
+        unsigned int hw = std::thread::hardware_concurrency();
+        if (hw == 0)
+            hw = 2;
+        unsigned int by_size = n / min_chunk;
+        if (by_size < 1)
+            by_size = 1;
+        return hw < by_size ? hw : by_size;
+    }
+
+    /**
+     * @brief Esegue f(0), ..., f(workers-1) in parallelo
+     * 
+     * f(0) viene eseguita dal thread chiamante, le altre da thread dedicati.
+     * Se una invocazione lancia un'eccezione, la prima (in ordine di indice)
+     * viene rilanciata dopo la terminazione di tutti i thread
+     * 
+     * @tparam F tipo del funtore, invocabile con un unsigned int
+     * @param workers numero di invocazioni
+     * @param f funtore da eseguire
+     */
+    template<typename F>
+    void parallel_for(unsigned int workers, F f){
+        std::vector<std::exception_ptr> errors(workers);
+        auto guarded = [&](unsigned int w){
+            try{
+                f(w);
+            }catch(...){
+                errors[w] = std::current_exception();
+            }
+        };
+        std::vector<std::thread> threads;
+        threads.reserve(workers);
+        try{
+            for(unsigned int w = 1; w < workers; ++w)
+                threads.push_back(std::thread(guarded, w));
+        }catch(...){
+            for(unsigned int t = 0; t < threads.size(); ++t)
+                threads[t].join();
+            throw;
+        }
+        if(workers > 0)
+            guarded(0);
+        for(unsigned int t = 0; t < threads.size(); ++t)
+            threads[t].join();
+        for(unsigned int w = 0; w < workers; ++w)
+            if(errors[w])
+                std::rethrow_exception(errors[w]);
+    }
+}
+
+#endif
@@ -1,7 +1,22 @@
 #include "Set.h"
+#include "VectorSet.h"
+#include "ConcurrentSet.h"
+#include "VersionedSet.h"
+#include "OrderedSet.h"
+#include "StaticSet.h"
+#include "MappedSet.h"
 #include <iostream>
 #include <cassert>
 #include <cmath>
+#include <functional>
+#include <vector>
+#include <thread>
+#include <string_view>
+#include <fstream>
+#include <sstream>
+#include <cstdio>
+#include <fcntl.h>
+#include <unistd.h>
 /**
  * @brief Struttura che implementa un punto 
  * 
@@ -130,6 +145,12 @@ class Concessionaria{
                  * @param other oggetto auto da cui copiare i dati
                  */
                 Auto(const Auto &other) : targa(other.targa), modello(other.modello){}
+                /**
+                 * @brief Move constructor
+                 * 
+                 * @param other oggetto auto da cui spostare i dati
+                 */
+                Auto(Auto &&other) : targa(std::move(other.targa)), modello(std::move(other.modello)){}
                 /**
                  * @brief Operatore assegnamento
                  * 
@@ -141,6 +162,17 @@ class Concessionaria{
                     modello=other.modello;
                     return *this;
                 }
+                /**
+                 * @brief Operatore assegnamento per spostamento
+                 * 
+                 * @param other oggetto auto da cui spostare i dati
+                 * @return oggetto this
+                 */
+                Auto& operator=(Auto &&other){
+                    targa=std::move(other.targa);
+                    modello=std::move(other.modello);
+                    return *this;
+                }
                 /**
                  * @brief Distruttore
                  * 
@@ -170,11 +202,18 @@ class Concessionaria{
         /**
          * @brief Funtore predicato di uguaglianza tra due auto
          * 
+         * Trasparente: confronta un'auto anche con una sola targa,
+         * così le ricerche per targa non costruiscono un'Auto temporanea
          */
         struct equals_auto{
+            typedef void is_transparent;
+
             bool operator()(const Auto &a, const Auto &b)const{
                 return a==b;
             }
+            bool operator()(const Auto &a, std::string_view targa)const{
+                return a.targa==targa;
+            }
         };
         
     private:
@@ -192,16 +231,7 @@ class Concessionaria{
          * 
          * @param other oggetto da cui copiare
          */
-        Concessionaria(const Concessionaria &other):_veicoli(){
-            Set<Auto, equals_auto>::const_iterator b,e;
-            try{
-                for(b=other._veicoli.begin(), e=other._veicoli.end(); b!=e; ++b)
-                    _veicoli.add(*b);
-            }catch(...){
-                _veicoli.clear();
-                throw;
-            }
-        }
+        Concessionaria(const Concessionaria &other):_veicoli(other._veicoli){}
         /**
          * @brief Operatore assegnamento
          * 
@@ -232,6 +262,15 @@ class Concessionaria{
         void add(const Auto &a){
             _veicoli.add(a);
         }
+        /**
+         * @brief Aggiunge un'auto solo se non esiste nella concessionaria,
+         * spostandone i dati senza copiarli
+         * 
+         * @param a 
+         */
+        void add(Auto &&a){
+            _veicoli.add(std::move(a));
+        }
         /**
          * @brief Rimuove un'auto solo se esiste nella concessionaria
          * 
@@ -250,6 +289,24 @@ class Concessionaria{
         bool contains(const Auto &a) const{
             return _veicoli.contains(a);
         }
+        /**
+         * @brief Verifica che un'auto con la targa passata sia presente nella concessionaria
+         * 
+         * @param targa targa da cercare
+         * @return true se l'auto è presente
+         * @return false altrimenti
+         */
+        bool contains(std::string_view targa) const{
+            return _veicoli.contains(targa);
+        }
+        /**
+         * @brief Rimuove l'auto con la targa passata solo se esiste nella concessionaria
+         * 
+         * @param targa targa dell'auto da rimuovere
+         */
+        void remove(std::string_view targa){
+            _veicoli.remove(targa);
+        }
         /**
          * @brief Numero delle auto
          * 
@@ -295,7 +352,7 @@ class Concessionaria{
          * @param veicoli lista di auto da aggiungere
          */
         void addAll(const Set<Auto, equals_auto> &veicoli){
-            _veicoli=_veicoli+veicoli; //se viene lanciata l'eccezione _veicoli non viene alterato
+            _veicoli+=veicoli; //se viene lanciata l'eccezione _veicoli non viene alterato
         }
         /**
          * @brief Rimuove tutte la auto
@@ -333,13 +390,41 @@ struct equals_string{
         return a==b;;
     }
 };
+/**
+ * @brief Uguaglianza trasparente tra stringhe: accetta anche std::string_view
+ * 
+ */
+struct equals_string_view{
+    typedef void is_transparent;
+
+    bool operator()(const std::string &a, std::string_view b) const{
+        return a==b;
+    }
+};
+/**
+ * @brief Hash trasparente tra stringhe: stesso valore per std::string e std::string_view
+ * 
+ */
+struct hash_string_view{
+    typedef void is_transparent;
+
+    std::size_t operator()(std::string_view s) const{
+        return std::hash<std::string_view>()(s);
+    }
+};
+/**
+ * @brief equals_int su int coincide con operator==: abilita la ricerca SIMD di VectorSet
+ * 
+ */
+template<>
+struct is_plain_equality<equals_int, int> : std::true_type {};
 /**
  * @brief Funtore predicato(generico) di uguaglianza tra due set
  * 
  */
 struct equals_set{
-    template<typename T, typename Eql>
-    bool operator()(const Set<T, Eql> &s1, const Set<T, Eql> &s2) const{
+    template<typename T, typename Eql, typename Hash, typename Alloc, unsigned int N>
+    bool operator()(const Set<T, Eql, Hash, Alloc, N> &s1, const Set<T, Eql, Hash, Alloc, N> &s2) const{
         return s1==s2;
     }
 };
@@ -769,6 +854,1437 @@ int test_const_iterator(){
     return 0;
 }
 
+/**
+ * @brief Test rimozione in testa, al centro e in coda e successivi inserimenti in coda
+ * 
+ */
+int test_remove_add_coda(){
+    int v[5]={1, 2, 3, 4, 5};
+    Set<int, equals_int> s(v, v+5);
+    s.remove(5);
+    s.add(6);
+    assert(s.size()==5 && s[4]==6);
+    s.remove(1);
+    s.remove(3);
+    assert(s.size()==3 && s[0]==2 && s[1]==4 && s[2]==6);
+    s.remove(2);
+    s.remove(4);
+    s.remove(6);
+    assert(s.isEmpty());
+    s.add(9);
+    s.add(9);
+    s.add(8);
+    assert(s.size()==2 && s[0]==9 && s[1]==8);
+    Set<int, equals_int> copy(s);
+    copy.add(7);
+    assert(copy.size()==3 && copy[2]==7);
+    return 0;
+}
+
+/**
+ * @brief Funtore hash di un point
+ * 
+ */
+struct hash_point{
+    std::size_t operator()(const point &p) const{
+        return std::hash<int>()(p.x) * 31 + std::hash<int>()(p.y);
+    }
+};
+/**
+ * @brief Test set con indice hash
+ * 
+ */
+int test_set_hash(){
+    Set<int, equals_int, std::hash<int> > s, empty;
+    assert(!s.contains(0));
+    s.remove(0);
+    for(int i=0; i<100000; ++i)
+        s.add(i);
+    for(int i=0; i<100000; ++i)
+        s.add(i);
+    assert(s.size()==100000);
+    assert(s.contains(99999) && !s.contains(100000));
+    for(int i=0; i<100000; i+=2)
+        s.remove(i);
+    assert(s.size()==50000);
+    assert(!s.contains(0) && s.contains(1));
+    assert(s[0]==1 && s[1]==3 && s[49999]==99999);
+    s.add(0);
+    assert(s[50000]==0); //ordine di inserimento preservato
+    Set<int, equals_int, std::hash<int> > copy(s);
+    assert(copy==s);
+    copy.remove(0);
+    assert(!(copy==s));
+    assert(s-empty==empty);
+    assert((s+empty).size()==s.size());
+    s.clear();
+    assert(s.isEmpty() && !s.contains(1));
+    s.add(7);
+    assert(s.size()==1 && s[0]==7);
+
+    point set_of_points[9]={point(-1,-5),point(0,0),point(1,-4),point(-4,-3),point(10,3),point(4,-1),point(-2,1),point(-9,-7),point(2,1)};
+    Set<point, equals_point, hash_point> sp(set_of_points, set_of_points+9);
+    Set<point, equals_point, hash_point> sp_copy(set_of_points, set_of_points+9);
+    assert(sp==sp_copy);
+    assert(filter_out(sp, is_located_in_quadrant_4).size()==3);
+    std::cout<<"Insieme hash={ "<<sp<<"}"<<std::endl;
+
+    Set<std::string, equals_string, std::hash<std::string> > ss;
+    for(int i=0; i<1000; ++i)
+        ss.add(std::to_string(i%500));
+    assert(ss.size()==500);
+    assert(ss.contains("499") && !ss.contains("500"));
+    return 0;
+}
+
+/**
+ * @brief Test classe VectorSet
+ * 
+ */
+int test_vector_set(){
+    point set_of_points[9]={point(-1,-5),point(0,0),point(1,-4),point(-4,-3),point(10,3),point(4,-1),point(-2,1),point(-9,-7),point(2,1)};
+    VectorSet<point, equals_point> s(set_of_points, set_of_points+9);
+    VectorSet<point, equals_point> ss(set_of_points, set_of_points+9);
+    VectorSet<point, equals_point> empty;
+    assert(s==ss);
+    assert(s.size()==9);
+    assert(s[0]==point(-1,-5) && s[8]==point(2,1));
+    assert(filter_out(s, is_located_in_quadrant_4).size()==3);
+    assert(s+ss==s);
+    assert(s-empty==empty);
+    try{
+        s[9];
+    }catch(set_index_out_of_bound &e){
+        std::cout<<e.what()<<std::endl;
+    }
+    s.remove(point(0,0));
+    assert(s.size()==8 && s[1]==point(1,-4));
+    assert(!(s==ss));
+    VectorSet<point, equals_point>::const_iterator b=s.begin(), e=s.end(), a, c;
+    assert(a==c);
+    assert(e-b==8);
+    assert(b[2]==point(-4,-3));
+    assert(*(b+7)==point(2,1));
+    assert(*(--e)==point(2,1));
+    std::cout<<"VectorSet={ "<<s<<"}"<<std::endl;
+
+    VectorSet<int, equals_int> vi;
+    for(int i=0; i<1000; ++i)
+        vi.add(i%100);
+    assert(vi.size()==100);
+    for(int i=0; i<(int)vi.size(); ++i)
+        assert(vi[i]==i);
+    vi.add(vi[0]);
+    assert(vi.size()==100);
+    VectorSet<int, equals_int> copy;
+    copy=vi;
+    assert(copy==vi);
+    copy.clear();
+    assert(copy.isEmpty() && copy.begin()==copy.end());
+
+    VectorSet<std::string, equals_string> vs;
+    for(int i=0; i<100; ++i)
+        vs.add(std::to_string(i%10));
+    vs.remove("0");
+    assert(vs.size()==9 && vs[0]=="1" && vs.contains("9"));
+    return 0;
+}
+
+/**
+ * @brief Confronta la ricerca SIMD con quella scalare su array di lunghezza variabile
+ * 
+ */
+template<typename T>
+void test_simd_find_tipo(){
+    T data[70];
+    for(int n=0; n<70; ++n){
+        for(int i=0; i<n; ++i)
+            data[i]=static_cast<T>(i*3+1);
+        for(int v=-1; v<n*3+2; ++v){
+            unsigned int expected=n;
+            for(int i=0; i<n; ++i)
+                if(data[i]==static_cast<T>(v)){
+                    expected=i;
+                    break;
+                }
+            assert(simd_find(data, n, static_cast<T>(v))==expected);
+        }
+    }
+}
+/**
+ * @brief Test ricerca SIMD di VectorSet
+ * 
+ */
+int test_simd_contains(){
+    test_simd_find_tipo<char>();
+    test_simd_find_tipo<short>();
+    test_simd_find_tipo<int>();
+    test_simd_find_tipo<unsigned int>();
+    test_simd_find_tipo<long long>();
+    test_simd_find_tipo<float>();
+    test_simd_find_tipo<double>();
+
+    VectorSet<int, equals_int> s;
+    for(int i=0; i<1000; ++i)
+        s.add(i%333);
+    assert(s.size()==333);
+    assert(s.contains(0) && s.contains(332) && !s.contains(333) && !s.contains(-1));
+    s.remove(100);
+    assert(!s.contains(100) && s[100]==101);
+
+    VectorSet<double, std::equal_to<double> > d;
+    d.add(0.5);
+    d.add(-0.0);
+    d.add(0.0); //uguale a -0.0 per operator==
+    assert(d.size()==2 && d.contains(0.0) && d.contains(0.5));
+
+    VectorSet<double, equals_int> troncati; //equals_int su double non è operator==: nessuna ricerca SIMD
+    troncati.add(1.1);
+    troncati.add(1.9);
+    assert(troncati.size()==1);
+    return 0;
+}
+
+/**
+ * @brief Tipo che conta le copie e gli spostamenti subiti
+ * 
+ */
+struct tracciato{
+    static int copie;///< numero di copie effettuate
+    static int spostamenti;///< numero di spostamenti effettuati
+    int id;///< identificativo
+
+    tracciato(int i) : id(i) {}
+    tracciato(int i, int j) : id(i*j) {}
+    tracciato(const tracciato &other) : id(other.id) { ++copie; }
+    tracciato(tracciato &&other) : id(other.id) { ++spostamenti; }
+    tracciato& operator=(const tracciato &other){
+        id=other.id;
+        ++copie;
+        return *this;
+    }
+    friend std::ostream& operator<<(std::ostream &os, const tracciato &t){
+        return os<<t.id;
+    }
+};
+int tracciato::copie=0;
+int tracciato::spostamenti=0;
+/**
+ * @brief Funtore predicato di uguaglianza tra due tracciato
+ * 
+ */
+struct equals_tracciato{
+    bool operator()(const tracciato &a, const tracciato &b) const{
+        return a.id==b.id;
+    }
+};
+/**
+ * @brief Funtore hash di un tracciato
+ * 
+ */
+struct hash_tracciato{
+    std::size_t operator()(const tracciato &t) const{
+        return std::hash<int>()(t.id);
+    }
+};
+/**
+ * @brief Test move constructor, move assignment, add(T&&) ed emplace
+ * 
+ */
+int test_move_semantics(){
+    Set<tracciato, equals_tracciato, hash_tracciato> a;
+    tracciato::copie=0;
+    for(int i=0; i<100; ++i)
+        a.add(tracciato(i));
+    a.emplace(100);
+    a.emplace(10, 10); //duplicato, non viene inserito
+    a.emplace(7, 30);
+    assert(a.size()==102);
+    assert(tracciato::copie==0);
+
+    Set<tracciato, equals_tracciato, hash_tracciato> b(std::move(a));
+    assert(a.isEmpty() && b.size()==102);
+    assert(b.contains(tracciato(210)) && !a.contains(tracciato(210)));
+    a=std::move(b);
+    assert(b.isEmpty() && a.size()==102);
+    assert(a[100].id==100 && a[101].id==210);
+    assert(tracciato::copie==0);
+    b.add(tracciato(1000)); //un set spostato resta utilizzabile
+    assert(b.size()==1);
+
+    Set<tracciato, equals_tracciato> lista;
+    lista.emplace(1);
+    lista.emplace(1);
+    lista.add(tracciato(2));
+    Set<tracciato, equals_tracciato> filtrato;
+    filtrato=filter_out(lista, [](const tracciato &t){ return t.id>0; });
+    assert(filtrato.size()==2);
+
+    Concessionaria c;
+    Concessionaria::Auto auto1("targa001", "audi");
+    c.add(std::move(auto1));
+    assert(c.veicoli()==1 && auto1.targa.empty());
+    c.addAll(Set<Concessionaria::Auto, Concessionaria::equals_auto>());
+    assert(c.veicoli()==1);
+    return 0;
+}
+
+/**
+ * @brief Test operator== lineare: impronta del contenuto e confronto dei prefissi
+ * 
+ */
+int test_operator_uguale_lineare(){
+    Set<int, equals_int, std::hash<int> > a, b, c;
+    for(int i=0; i<1000; ++i){
+        a.add(i);
+        b.add(999-i);
+    }
+    assert(a.fingerprint()==b.fingerprint());
+    assert(a==b && b==a);
+    c.add(1);
+    c.add(4);
+    Set<int, equals_int, std::hash<int> > d;
+    d.add(2);
+    d.add(3);
+    assert(c.fingerprint()!=d.fingerprint());
+    assert(!(c==d));
+    b.remove(500);
+    b.add(1000);
+    assert(!(a==b));
+    b.remove(1000);
+    b.add(500);
+    assert(a==b && a.fingerprint()==b.fingerprint());
+    Set<int, equals_int, std::hash<int> > empty;
+    assert(empty.fingerprint()==0);
+    a.clear();
+    assert(a==empty);
+
+    int v1[6]={1, 2, 3, 4, 5, 6};
+    int v2[6]={1, 2, 6, 5, 4, 3};
+    int v3[6]={1, 2, 6, 5, 4, 7};
+    Set<int, equals_int> l1(v1, v1+6), l2(v2, v2+6), l3(v3, v3+6);
+    assert(l1==l2 && l2==l1);
+    assert(!(l1==l3) && !(l3==l1));
+    assert((l1==Set<int, equals_int>(l1)));
+
+    point p1[3]={point(0,0), point(1,1), point(2,2)};
+    point p2[3]={point(2,2), point(0,0), point(1,1)};
+    Set<Set<point, equals_point, hash_point>, equals_set, set_hash> matrix;
+    matrix.add(Set<point, equals_point, hash_point>(p1, p1+3));
+    matrix.add(Set<point, equals_point, hash_point>(p2, p2+3)); //stesso contenuto, non viene aggiunto
+    matrix.add(Set<point, equals_point, hash_point>(p1, p1+2));
+    assert(matrix.size()==2);
+    assert((matrix.contains(Set<point, equals_point, hash_point>(p2+1, p2+3))));
+    return 0;
+}
+
+/**
+ * @brief Test unione, intersezione, differenza e differenza simmetrica
+ * 
+ */
+int test_operazioni_insiemi(){
+    int va[6]={1, 2, 3, 4, 5, 6};
+    int vb[5]={9, 4, 2, 8, 7};
+    Set<int, equals_int> a(va, va+6), b(vb, vb+5), empty;
+    Set<int, equals_int, std::hash<int> > ha(va, va+6), hb(vb, vb+5);
+    std::hash<int> h;
+
+    Set<int, equals_int> u=a+b;
+    assert(u.size()==9 && u[5]==6 && u[6]==9 && u[8]==7);
+    assert(u==set_union(a, b, h) && u==set_union(b, a, h));
+    assert(set_union(a, b, h)[6]==9); //ordine: A seguito dai nuovi elementi di B
+    assert(set_union(a, empty, h)==a && set_union(empty, a, h)==a);
+
+    Set<int, equals_int> i=a-b;
+    assert(i.size()==2 && i[0]==2 && i[1]==4);
+    assert(set_intersection(a, b, h)[0]==2 && set_intersection(b, a, h)[0]==4);
+    assert(set_intersection(a, b, h)==i && set_intersection(a, empty, h).isEmpty());
+
+    Set<int, equals_int> d=difference(a, b);
+    assert(d.size()==4 && d[0]==1 && d[1]==3 && d[2]==5 && d[3]==6);
+    assert(difference(a, b, h)==d && difference(b, a, h).size()==3);
+    assert(difference(a, a).isEmpty() && difference(a, empty)==a);
+
+    Set<int, equals_int> sd=symmetric_difference(a, b);
+    assert(sd.size()==7 && sd[3]==6 && sd[4]==9);
+    assert(symmetric_difference(a, b, h)==sd && symmetric_difference(b, a, h)==sd);
+    assert(symmetric_difference(a, a).isEmpty());
+
+    assert((ha+hb).size()==9 && (ha-hb).size()==2);
+    assert(difference(ha, hb).size()==4 && symmetric_difference(ha, hb).size()==7);
+
+    Set<int, equals_int> grande, piccolo;
+    for(int k=0; k<5000; ++k)
+        grande.add(k%2==0 ? k : -k);
+    for(int k=0; k<100; ++k)
+        piccolo.add(k);
+    assert(set_intersection(grande, piccolo, h).size()==50);
+    assert(set_union(piccolo, grande, h).size()==5050);
+    assert(difference(grande, piccolo, h).size()==4950);
+    return 0;
+}
+
+/**
+ * @brief Tipo la cui copia fallisce dopo un certo numero di copie
+ * 
+ */
+struct fragile{
+    static int copie_rimaste;///< copie consentite prima dell'eccezione
+    int id;///< identificativo
+
+    fragile(int i) : id(i) {}
+    fragile(const fragile &other) : id(other.id){
+        if(copie_rimaste--<=0)
+            throw std::bad_alloc();
+    }
+};
+int fragile::copie_rimaste=1000;
+/**
+ * @brief Funtore predicato di uguaglianza tra due fragile
+ * 
+ */
+struct equals_fragile{
+    bool operator()(const fragile &a, const fragile &b) const{
+        return a.id==b.id;
+    }
+};
+/**
+ * @brief Test operazioni sul posto: +=, -=, erase_if, retain_if
+ * 
+ */
+int test_operazioni_sul_posto(){
+    int va[6]={1, 2, 3, 4, 5, 6};
+    int vb[5]={9, 4, 2, 8, 7};
+    Set<int, equals_int> a(va, va+6), b(vb, vb+5);
+    a+=b;
+    assert(a.size()==9 && a[6]==9 && a[8]==7);
+    a+=a;
+    assert(a.size()==9);
+    a-=b;
+    assert(a.size()==5 && a[0]==2 && a[1]==4 && a[2]==9);
+    a-=a;
+    assert(a.size()==5);
+
+    Set<int, equals_int, std::hash<int> > ha(va, va+6), hb(vb, vb+5);
+    ha+=std::move(hb);
+    assert(hb.isEmpty() && ha.size()==9 && ha.contains(8) && ha[8]==7);
+    hb.add(100); //il set svuotato resta utilizzabile
+    assert(hb.size()==1 && hb.contains(100));
+    Set<int, equals_int, std::hash<int> > copy(ha);
+    ha.add(50);
+    ha.remove(50);
+    assert(ha==copy);
+    assert(ha.erase_if(is_even)==4);
+    assert(ha.size()==5 && !ha.contains(2) && ha.contains(9));
+    assert(ha.retain_if([](int x){ return x>3; })==2);
+    assert(ha.size()==3 && ha[0]==5 && ha[1]==9 && ha[2]==7);
+    ha.clear();
+    ha+=copy;
+    assert(ha==copy);
+
+    //garanzia forte: la copia fallisce a metà dell'unione
+    Set<fragile, equals_fragile> f, g;
+    for(int i=0; i<10; ++i){
+        f.add(fragile(i));
+        g.add(fragile(i+5));
+    }
+    fragile::copie_rimaste=2;
+    try{
+        f+=g;
+        assert(false);
+    }catch(std::bad_alloc &){
+    }
+    fragile::copie_rimaste=1000;
+    assert(f.size()==10 && f[9].id==9);
+    f.add(fragile(42));
+    assert(f.size()==11 && f[10].id==42);
+
+    //il predicato lancia un'eccezione: il set non viene alterato
+    try{
+        f.erase_if([](const fragile &x){ if(x.id==5) throw 5; return x.id<3; });
+    }catch(int){
+    }
+    assert(f.size()==11);
+
+    Concessionaria c;
+    Set<Concessionaria::Auto, Concessionaria::equals_auto> nuove;
+    nuove.add(Concessionaria::Auto("targa1", "fiat"));
+    c.addAll(nuove);
+    c.addAll(nuove);
+    assert(c.veicoli()==1);
+    return 0;
+}
+
+/**
+ * @brief Funtore di uguaglianza tra interi che conta le invocazioni
+ * 
+ */
+struct equals_int_contato{
+    static int confronti;///< numero di confronti effettuati
+    bool operator()(int a, int b) const{
+        ++confronti;
+        return a==b;
+    }
+};
+int equals_int_contato::confronti=0;
+/**
+ * @brief Test copia, filter_out e operator+ senza ricerca dei duplicati
+ * 
+ */
+int test_accodamento_senza_duplicati(){
+    Set<int, equals_int_contato> s, vuoto;
+    for(int i=0; i<1000; ++i)
+        s.add(i);
+    equals_int_contato::confronti=0;
+    Set<int, equals_int_contato> copy(s);
+    assert(copy.size()==1000 && equals_int_contato::confronti==0);
+    Set<int, equals_int_contato> pari=filter_out(s, is_even);
+    assert(pari.size()==500 && equals_int_contato::confronti==0);
+    Set<int, equals_int_contato> u=s+vuoto;
+    assert(u.size()==1000 && equals_int_contato::confronti==0);
+    assert(pari[1]==2 && copy[999]==999);
+    return 0;
+}
+
+/**
+ * @brief Test filter_out con politiche di esecuzione
+ * 
+ */
+int test_filter_out_parallelo(){
+    Set<int, equals_int, std::hash<int> > s;
+    for(int i=0; i<100000; ++i)
+        s.add(i*7 % 100003);
+    Set<int, equals_int, std::hash<int> > seq=filter_out(execution::seq, s, is_even);
+    Set<int, equals_int, std::hash<int> > par=filter_out(execution::par, s, is_even);
+    Set<int, equals_int, std::hash<int> > par_unseq=filter_out(execution::par_unseq, s, is_even);
+    assert(seq==par && seq==par_unseq);
+    assert(seq.size()==par.size());
+    for(unsigned int i=0; i<seq.size(); i+=997)
+        assert(seq[i]==par[i]); //stesso ordine del filtro sequenziale
+
+    point set_of_points[9]={point(-1,-5),point(0,0),point(1,-4),point(-4,-3),point(10,3),point(4,-1),point(-2,1),point(-9,-7),point(2,1)};
+    Set<point, equals_point> piccolo(set_of_points, set_of_points+9);
+    assert(filter_out(execution::par, piccolo, is_located_in_quadrant_4).size()==3);
+
+    bool lanciata=false;
+    try{
+        filter_out(execution::par, s, [](int x){ if(x==99999) throw set_index_out_of_bound("predicato"); return true; });
+    }catch(set_index_out_of_bound &){
+        lanciata=true;
+    }
+    assert(lanciata);
+    return 0;
+}
+
+/**
+ * @brief Test costruzione parallela a partire da iteratori
+ * 
+ */
+int test_costruzione_parallela(){
+    std::vector<int> dati;
+    for(int i=0; i<50000; ++i)
+        dati.push_back((i*7919) % 12347); //molti duplicati, prima occorrenza sparsa
+    Set<int, equals_int, std::hash<int> > seriale(dati.begin(), dati.end());
+    Set<int, equals_int, std::hash<int> > parallelo(execution::par, dati.begin(), dati.end());
+    Set<int, equals_int, std::hash<int> > sequenziale(execution::seq, dati.begin(), dati.end());
+    assert(seriale.size()==12347);
+    assert(parallelo.size()==seriale.size() && sequenziale.size()==seriale.size());
+    for(unsigned int i=0; i<seriale.size(); ++i)
+        assert(seriale[i]==parallelo[i]);
+    assert(parallelo==seriale && parallelo.fingerprint()==seriale.fingerprint());
+    parallelo.add(20000);
+    parallelo.remove(0);
+    assert(parallelo.size()==12347 && parallelo.contains(20000) && !parallelo.contains(0));
+
+    float vettore[5]={1.1, 3.4, 1.9, -0.001, 3.0};
+    Set<int, equals_int, std::hash<int> > convertiti(execution::par, vettore, vettore+5);
+    assert(convertiti.size()==3 && convertiti[0]==1 && convertiti[1]==3 && convertiti[2]==0);
+    Set<int, equals_int, std::hash<int> > vuoto(execution::par, vettore, vettore);
+    assert(vuoto.isEmpty());
+
+    std::string nomi[6]={"audi", "bmw", "audi", "fiat", "bmw", "tesla"};
+    Set<std::string, equals_string, std::hash<std::string> > marche(execution::par, nomi, nomi+6);
+    assert(marche.size()==4 && marche[3]=="tesla");
+    Set<std::string, equals_string> senza_indice(execution::par, nomi, nomi+6);
+    assert(senza_indice.size()==4 && senza_indice[2]=="fiat");
+    return 0;
+}
+
+/**
+ * @brief Test ConcurrentSet con più thread lettori e scrittori
+ * 
+ */
+int test_concurrent_set(){
+    ConcurrentSet<int, equals_int, std::hash<int> > s;
+    assert(s.isEmpty());
+    const unsigned int scrittori=4;
+    std::vector<int> aggiunti(scrittori, 0);
+    std::vector<std::thread> threads;
+    for(unsigned int t=0; t<scrittori; ++t)
+        threads.push_back(std::thread([&s, &aggiunti, t](){
+            for(int i=0; i<20000; ++i)
+                if(s.add(i%10000 + static_cast<int>(t)*5000)) //intervalli sovrapposti a coppie
+                    aggiunti[t]++;
+        }));
+    for(unsigned int t=0; t<scrittori; ++t)
+        threads.push_back(std::thread([&s](){
+            for(int i=0; i<20000; ++i)
+                s.contains(i);
+        }));
+    for(unsigned int t=0; t<threads.size(); ++t)
+        threads[t].join();
+    assert(s.size()==25000);
+    assert(aggiunti[0]+aggiunti[1]+aggiunti[2]+aggiunti[3]==25000);
+    assert(s.contains(0) && s.contains(24999) && !s.contains(25000));
+
+    threads.clear();
+    for(unsigned int t=0; t<scrittori; ++t)
+        threads.push_back(std::thread([&s, t](){
+            for(int i=static_cast<int>(t); i<25000; i+=scrittori)
+                if(i%2==0){
+                    bool rimosso=s.remove(i);
+                    assert(rimosso);
+                }
+        }));
+    for(unsigned int t=0; t<threads.size(); ++t)
+        threads[t].join();
+    assert(s.size()==12500 && !s.contains(0) && s.contains(1));
+    bool rimosso=s.remove(0);
+    assert(!rimosso);
+
+    long long somma=0;
+    s.for_each([&somma](int x){ somma+=x; });
+    assert(somma==12500LL*12500); //somma dei dispari minori di 25000
+    Set<int, equals_int, std::hash<int> > copia=s.snapshot();
+    assert(copia.size()==12500 && copia.contains(24999) && !copia.contains(2));
+
+    s.clear();
+    assert(s.isEmpty() && !s.contains(1));
+
+    int dati[6]={3, 1, 3, 2, 1, 5};
+    ConcurrentSet<int, equals_int, std::hash<int>, 4> piccolo(dati, dati+6);
+    assert(piccolo.size()==4 && piccolo.contains(5));
+
+    //molti elementi: la scelta della partizione non deve creare cluster nelle
+    //tabelle interne, altrimenti add e contains diventano quadratici
+    //(il confronto dei tempi con Set è nel benchmark: concurrent_int)
+    const int molti=400000;
+    ConcurrentSet<int, equals_int, std::hash<int> > grande;
+    for(int i=0; i<molti; ++i)
+        grande.add(i);
+    bool tutti=true;
+    for(int i=0; i<molti; ++i)
+        tutti=tutti && grande.contains(i);
+    assert(tutti && grande.size()==static_cast<unsigned int>(molti) && !grande.contains(molti));
+    return 0;
+}
+
+/**
+ * @brief Test snapshot immutabili di VersionedSet con uno scrittore e più lettori
+ * 
+ */
+int test_versioned_set(){
+    VersionedSet<int, equals_int, std::hash<int> > s;
+    SetSnapshot<int, equals_int> vuoto=s.snapshot();
+    const int n=20000;
+    std::thread scrittore([&s](){
+        for(int i=0; i<n; ++i)
+            s.add(i);
+    });
+    std::vector<std::thread> lettori;
+    for(int t=0; t<3; ++t)
+        lettori.push_back(std::thread([&s](){
+            for(int k=0; k<200; ++k){
+                SetSnapshot<int, equals_int> v=s.snapshot();
+                int atteso=0;
+                for(SetSnapshot<int, equals_int>::const_iterator b=v.begin(), e=v.end(); b!=e; ++b)
+                    assert(*b==atteso++); //versione coerente: prefisso in ordine di inserimento
+                assert(static_cast<unsigned int>(atteso)==v.size());
+            }
+        }));
+    scrittore.join();
+    for(unsigned int t=0; t<lettori.size(); ++t)
+        lettori[t].join();
+    assert(vuoto.isEmpty() && vuoto.begin()==vuoto.end());
+    bool aggiunto=s.add(5);
+    assert(s.size()==n && !aggiunto && s.contains(n-1));
+
+    SetSnapshot<int, equals_int> prima=s.snapshot();
+    for(int i=0; i<n; ++i)
+        if(i%3!=0){
+            bool rimosso=s.remove(i); //provoca la ricompattazione
+            assert(rimosso);
+        }
+    bool rimosso=s.remove(1);
+    assert(!rimosso);
+    SetSnapshot<int, equals_int> dopo=s.snapshot();
+    assert(prima.size()==n && prima.contains(1)); //la versione precedente non cambia
+    assert(dopo.size()==(n+2)/3 && !dopo.contains(1) && dopo.contains(3));
+    int atteso=0;
+    for(SetSnapshot<int, equals_int>::const_iterator b=dopo.begin(); b!=dopo.end(); b++, atteso+=3)
+        assert(*b==atteso);
+    aggiunto=s.add(1);
+    assert(aggiunto && s.snapshot().contains(1) && !dopo.contains(1));
+
+    s.clear();
+    assert(s.isEmpty() && dopo.size()==(n+2)/3);
+
+    std::string nomi[5]={"audi", "bmw", "audi", "fiat", "bmw"};
+    VersionedSet<std::string, equals_string> marche(nomi, nomi+5);
+    assert(marche.size()==3 && marche.contains("fiat"));
+    rimosso=marche.remove("audi");
+    assert(rimosso && *marche.snapshot().begin()=="bmw");
+    return 0;
+}
+
+/**
+ * @brief Test accesso posizionale in tempo costante con operator[]
+ * 
+ */
+int test_operator_parentesi_quadre_costante(){
+    Set<int, equals_int, std::hash<int> > s;
+    const int n=200000;
+    for(int i=0; i<n; ++i)
+        s.add(i);
+    long long somma=0;
+    for(unsigned int i=0; i<s.size(); ++i)
+        somma+=s[i]; //O(n) in totale
+    assert(somma==static_cast<long long>(n)*(n-1)/2);
+
+    s.add(n); //l'inserimento in coda lascia valida la cache
+    assert(s[n]==n && s[n-1]==n-1);
+    s.remove(n); //rimozione dell'ultimo elemento
+    assert(s.size()==n && s[n-1]==n-1);
+    s.remove(0);
+    s.remove(5);
+    assert(s[0]==1 && s[4]==6 && s[n-3]==n-1);
+    s.erase_if([](int x){ return x%2==0; });
+    assert(s.size()==n/2-1 && s[1]==3 && s[2]==7 && s[n/2-2]==n-1); //5 era già stato rimosso
+    bool lanciata=false;
+    try{
+        s[n/2-1];
+    }catch(set_index_out_of_bound &){
+        lanciata=true;
+    }
+    assert(lanciata);
+
+    Set<int, equals_int, std::hash<int> > copia(s);
+    Set<int, equals_int, std::hash<int> > spostato(std::move(s));
+    assert(spostato[2]==7 && copia[2]==7);
+    spostato.clear();
+    spostato.add(42);
+    assert(spostato[0]==42);
+
+    Set<std::string, equals_string> nomi;
+    nomi.add("audi");
+    nomi.add("bmw");
+    nomi.add("fiat");
+    assert(nomi[2]=="fiat");
+    nomi.remove("audi");
+    assert(nomi[0]=="bmw" && nomi[1]=="fiat");
+
+    //rimozioni e accessi alternati: la cache viene troncata, non svuotata
+    Set<int, equals_int, std::hash<int> > alternato;
+    for(int i=0; i<1000; ++i)
+        alternato.add(i);
+    assert(alternato[999]==999);
+    for(int i=0; i<500; ++i){
+        alternato.remove(2*i+1);
+        assert(alternato[i]==2*i && alternato[alternato.size()-1]==(i==499 ? 998 : 999));
+    }
+
+    //più thread leggono lo stesso set costante tramite operator[]
+    const Set<int, equals_int, std::hash<int> > &condiviso=copia;
+    long long totale=0;
+    for(Set<int, equals_int, std::hash<int> >::const_iterator b=copia.begin(); b!=copia.end(); ++b)
+        totale+=*b;
+    std::vector<std::thread> lettori;
+    std::vector<long long> somme(4, 0);
+    for(unsigned int t=0; t<somme.size(); ++t)
+        lettori.push_back(std::thread([&condiviso, &somme, t](){
+            for(unsigned int i=t%2; i<condiviso.size(); i+=2)
+                somme[t]+=condiviso[i];
+        }));
+    for(unsigned int t=0; t<lettori.size(); ++t)
+        lettori[t].join();
+    assert(somme[0]==somme[2] && somme[1]==somme[3] && somme[0]+somme[1]==totale);
+    return 0;
+}
+
+/**
+ * @brief Funtore di ordinamento lessicografico su point: prima x, poi y
+ * 
+ */
+struct less_point{
+    bool operator()(const point &a, const point &b) const{
+        return a.x<b.x || (a.x==b.x && a.y<b.y);
+    }
+};
+
+/**
+ * @brief Test OrderedSet: ricerca logaritmica e interrogazioni per intervallo
+ * 
+ */
+int test_ordered_set(){
+    OrderedSet<int> s;
+    std::vector<char> presente(5000, 0);
+    unsigned int attesi=0;
+    unsigned int seme=12345;
+    for(int k=0; k<40000; ++k){
+        seme=seme*1103515245u+12345u;
+        int v=static_cast<int>((seme>>8)%5000);
+        if((seme>>4)%3==0){
+            s.remove(v);
+            attesi-=presente[v];
+            presente[v]=0;
+        }else{
+            s.add(v);
+            attesi+=1-presente[v];
+            presente[v]=1;
+        }
+    }
+    assert(s.size()==attesi);
+    int precedente=-1;
+    unsigned int visitati=0;
+    for(OrderedSet<int>::const_iterator b=s.begin(); b!=s.end(); ++b, ++visitati){
+        assert(*b>precedente && presente[*b]); //ordine crescente, nessun duplicato
+        precedente=*b;
+    }
+    assert(visitati==attesi);
+    for(int v=0; v<5000; ++v)
+        assert(s.contains(v)==(presente[v]!=0));
+
+    OrderedSet<int> pari;
+    for(int i=0; i<100; i+=2)
+        pari.add(i);
+    assert(*pari.lower_bound(10)==10 && *pari.upper_bound(10)==12 && *pari.lower_bound(11)==12);
+    assert(pari.lower_bound(99)==pari.end() && *--pari.end()==98);
+    int somma=0;
+    for(int x : pari.range(10, 20))
+        somma+=x;
+    assert(somma==10+12+14+16+18);
+    assert(pari.range(20, 10).begin()==pari.range(20, 10).end());
+
+    OrderedSet<int> copia(pari);
+    assert(copia==pari);
+    copia.remove(50);
+    assert(copia!=pari && copia.size()==49 && !copia.contains(50));
+    OrderedSet<int> spostato(std::move(copia));
+    assert(copia.isEmpty() && spostato.size()==49);
+    copia=pari;
+    assert(copia==pari);
+    copia.clear();
+    assert(copia.isEmpty() && copia.begin()==copia.end());
+
+    point set_of_points[9]={point(-1,-5),point(0,0),point(1,-4),point(-4,-3),point(10,3),point(4,-1),point(-2,1),point(-9,-7),point(2,1)};
+    OrderedSet<point, less_point> punti(set_of_points, set_of_points+9);
+    unsigned int nella_striscia=0;
+    for(const point &p : punti.range(point(0, -1000), point(5, -1000)))
+        nella_striscia+=(p.x>=0 && p.x<5); //0 <= x < 5
+    assert(nella_striscia==4);
+    assert(punti.begin()->x==-9);
+
+    std::string targhe[5]={"EF456GH", "AB123CD", "ZZ999ZZ", "CD001AA", "AB123CD"};
+    OrderedSet<std::string> ordinate(targhe, targhe+5);
+    assert(ordinate.size()==4 && *ordinate.begin()=="AB123CD");
+    unsigned int tra_b_e_e=0;
+    for(const std::string &t : ordinate.range("B", "F"))
+        tra_b_e_e+=(t=="CD001AA" || t=="EF456GH");
+    assert(tra_b_e_e==2);
+    return 0;
+}
+
+/**
+ * @brief Test StaticSet costruito a tempo di compilazione
+ * 
+ */
+int test_static_set(){
+    constexpr auto modelli=make_static_set<std::string_view>("panda", "golf", "clio", "golf", "model 3");
+    static_assert(modelli.size()==4, "i duplicati vengono ignorati");
+    static_assert(modelli.contains("clio") && !modelli.contains("punto"), "ricerca a tempo di compilazione");
+    static_assert(modelli[0]=="clio" && modelli[3]=="panda", "elementi ordinati");
+
+    constexpr StaticSet<int, 8> codici(30, 10, 20, 10);
+    static_assert(codici.size()==3 && codici.contains(20) && !codici.contains(15), "");
+    int somma=0;
+    for(int c : codici)
+        somma+=c;
+    assert(somma==60);
+
+    std::string letto="golf";
+    assert(modelli.contains(letto)); //std::string si converte in std::string_view
+    Set<std::string, equals_string> copia(modelli.begin(), modelli.end()); //interoperabilità con Set
+    assert(copia.size()==4 && copia.contains("model 3"));
+
+    constexpr StaticSet<int, 4> vuoto;
+    static_assert(vuoto.isEmpty() && !vuoto.contains(0), "");
+    bool lanciata=false;
+    try{
+        StaticSet<int, 2> pieno(1, 2, 3);
+    }catch(set_index_out_of_bound &){
+        lanciata=true;
+    }
+    assert(lanciata);
+    return 0;
+}
+
+/**
+ * @brief Hash diverso da quello usato per salvare i file di test_formato_binario
+ * 
+ */
+struct hash_diverso{
+    std::size_t operator()(int x) const{
+        return static_cast<std::size_t>(x)*7+1;
+    }
+};
+/**
+ * @brief Contenuto di un file
+ */
+std::string leggi_file(const char *path){
+    std::ifstream in(path, std::ios::binary);
+    std::stringstream contenuto;
+    contenuto<<in.rdbuf();
+    return contenuto.str();
+}
+/**
+ * @brief Scrive un file con il contenuto passato
+ */
+void scrivi_file(const char *path, const std::string &contenuto){
+    std::ofstream out(path, std::ios::binary);
+    out.write(contenuto.data(), contenuto.size());
+}
+/**
+ * @brief Vero se costruire e interrogare un MappedSet sul file lancia std::ios_base::failure
+ */
+template<typename M, typename V>
+bool mappato_corrotto(const char *path, const V &cercato){
+    try{
+        M m(path);
+        m.contains(cercato);
+        for(typename M::const_iterator b=m.begin(); b!=m.end(); ++b)
+            *b;
+    }catch(std::ios_base::failure &){
+        return true;
+    }
+    return false;
+}
+
+/**
+ * @brief Test salvataggio binario, caricamento e mappatura in memoria
+ * 
+ */
+int test_formato_binario(){
+    Set<int, equals_int, std::hash<int> > numeri;
+    for(int i=0; i<10000; ++i)
+        numeri.add(i*3);
+    std::stringstream buffer;
+    save(numeri, buffer);
+    Set<int, equals_int, std::hash<int> > riletti;
+    load(buffer, riletti);
+    assert(riletti==numeri && riletti[0]==0 && riletti[9999]==29997);
+
+    Set<double, std::equal_to<double> > misure; //non indicizzato: nessuna tabella nel file
+    misure.add(1.5);
+    misure.add(-3.25);
+    std::stringstream buffer_misure;
+    save(misure, buffer_misure);
+    Set<double, std::equal_to<double> > misure_rilette;
+    load(buffer_misure, misure_rilette);
+    assert(misure_rilette.size()==2 && misure_rilette[1]==-3.25);
+
+    const char *file_numeri="test_numeri.bin";
+    {
+        std::ofstream out(file_numeri, std::ios::binary);
+        save(numeri, out);
+    }
+    {
+        MappedSet<int, equals_int, std::hash<int> > mappato(file_numeri);
+        assert(mappato.size()==10000 && !mappato.isEmpty());
+        assert(mappato.contains(2997) && !mappato.contains(2998)); //tramite la tabella hash del file
+        long long somma=0;
+        for(MappedSet<int, equals_int, std::hash<int> >::const_iterator b=mappato.begin(); b!=mappato.end(); ++b)
+            somma+=*b;
+        assert(somma==3LL*9999*10000/2);
+        MappedSet<int, equals_int> senza_tabella(file_numeri);
+        assert(senza_tabella.contains(3) && !senza_tabella.contains(4)); //scansione lineare
+    }
+
+    Set<std::string, equals_string, std::hash<std::string> > modelli;
+    modelli.add("panda");
+    modelli.add("");
+    modelli.add("model 3");
+    const char *file_modelli="test_modelli.bin";
+    {
+        std::ofstream out(file_modelli, std::ios::binary);
+        save(modelli, out);
+    }
+    {
+        std::ifstream in(file_modelli, std::ios::binary);
+        Set<std::string, equals_string> riletti_modelli;
+        load(in, riletti_modelli);
+        assert(riletti_modelli.size()==3 && riletti_modelli[2]=="model 3" && riletti_modelli.contains(""));
+
+        MappedSet<std::string, equals_string, std::hash<std::string> > mappato(file_modelli);
+        assert(mappato.contains("panda") && mappato.contains("") && !mappato.contains("golf"));
+        assert(*mappato.begin()=="panda");
+
+        bool lanciata=false;
+        try{
+            MappedSet<int, equals_int> sbagliato(file_modelli); //elementi di tipo diverso
+        }catch(std::ios_base::failure &){
+            lanciata=true;
+        }
+        assert(lanciata);
+        lanciata=false;
+        try{
+            std::stringstream vuoto;
+            load(vuoto, riletti);
+        }catch(std::ios_base::failure &){
+            lanciata=true;
+        }
+        assert(lanciata && riletti.size()==10000); //il set di destinazione non viene alterato
+    }
+
+    //funtore hash diverso da quello del file: tabella ignorata, nessun falso negativo
+    {
+        MappedSet<int, equals_int, hash_diverso> altro_hash(file_numeri);
+        assert(altro_hash.contains(2997) && altro_hash.contains(0) && !altro_hash.contains(2998));
+    }
+
+    //file corrotti: std::ios_base::failure, mai letture fuori dalla mappatura o cicli infiniti
+    const char *file_corrotto="test_corrotto.bin";
+    std::string originale=leggi_file(file_numeri);
+    binary_header h;
+    std::memcpy(&h, originale.data(), sizeof(h));
+    std::size_t inizio_tabella=sizeof(h)+h.payload_bytes;
+
+    std::string corrotto=originale;
+    for(std::size_t i=inizio_tabella; i<corrotto.size(); ++i)
+        corrotto[i]='\xff'; //offset fuori dagli elementi
+    scrivi_file(file_corrotto, corrotto);
+    assert((mappato_corrotto<MappedSet<int, equals_int, std::hash<int> > >(file_corrotto, 3)));
+
+    corrotto=originale;
+    for(std::size_t i=inizio_tabella; i<corrotto.size(); i+=sizeof(std::uint64_t)){
+        std::uint64_t primo=1; //ogni slot punta al primo elemento: nessuno slot vuoto
+        std::memcpy(&corrotto[i], &primo, sizeof(primo));
+    }
+    scrivi_file(file_corrotto, corrotto);
+    assert((mappato_corrotto<MappedSet<int, equals_int, std::hash<int> > >(file_corrotto, 4)));
+
+    corrotto=originale.substr(0, inizio_tabella+3*sizeof(std::uint64_t));
+    binary_header non_potenza=h;
+    non_potenza.table_capacity=3;
+    std::memcpy(&corrotto[0], &non_potenza, sizeof(non_potenza));
+    scrivi_file(file_corrotto, corrotto);
+    assert((mappato_corrotto<MappedSet<int, equals_int, std::hash<int> > >(file_corrotto, 4)));
+
+    corrotto=originale;
+    int duplicato=0; //il secondo elemento diventa uguale al primo
+    std::memcpy(&corrotto[sizeof(h)+sizeof(int)], &duplicato, sizeof(duplicato));
+    scrivi_file(file_corrotto, corrotto);
+    assert((mappato_corrotto<MappedSet<int, equals_int, std::hash<int> > >(file_corrotto, 4)));
+    assert((mappato_corrotto<MappedSet<int, equals_int>, int>(file_corrotto, 4))); //senza tabella
+    {
+        std::ifstream in(file_corrotto, std::ios::binary);
+        Set<int, equals_int, std::hash<int> > non_caricato;
+        non_caricato.add(7);
+        bool lanciata=false;
+        try{
+            load(in, non_caricato);
+        }catch(std::ios_base::failure &){
+            lanciata=true;
+        }
+        assert(lanciata && non_caricato.size()==1 && non_caricato.contains(7));
+    }
+
+    std::string stringhe=leggi_file(file_modelli);
+    std::uint32_t enorme=0xFFFFFFF0u;
+    std::memcpy(&stringhe[sizeof(h)], &enorme, sizeof(enorme)); //lunghezza della prima stringa
+    scrivi_file(file_corrotto, stringhe);
+    assert((mappato_corrotto<MappedSet<std::string, equals_string>, std::string>(file_corrotto, "golf")));
+    {
+        std::ifstream in(file_corrotto, std::ios::binary);
+        Set<std::string, equals_string> non_caricato;
+        bool lanciata=false;
+        try{
+            load(in, non_caricato);
+        }catch(std::ios_base::failure &){
+            lanciata=true; //nessuna allocazione della lunghezza dichiarata
+        }
+        assert(lanciata && non_caricato.isEmpty());
+    }
+    std::remove(file_corrotto);
+    std::remove(file_numeri);
+    std::remove(file_modelli);
+    return 0;
+}
+
+/**
+ * @brief Test operator>> e caricamento testuale a blocchi
+ * 
+ */
+int test_caricamento_testuale(){
+    Set<int, equals_int, std::hash<int> > originale;
+    for(int i=0; i<3000; ++i)
+        originale.add((i*37)%2000-1000);
+    std::stringstream testo;
+    testo<<originale;
+    Set<int, equals_int, std::hash<int> > riletto;
+    testo>>riletto;
+    assert(riletto==originale && riletto[5]==originale[5] && !testo.fail());
+
+    std::stringstream errato("1 2 tre 4");
+    Set<int, equals_int> parziale;
+    errato>>parziale;
+    assert(errato.fail() && parziale.size()==2);
+    std::stringstream troncato("7 8 -"); //token finale incompleto: errore anche a fine stream
+    troncato>>parziale;
+    assert(troncato.fail() && parziale.size()==4);
+    std::stringstream senza_spazio("9 10");
+    senza_spazio>>parziale;
+    assert(!senza_spazio.fail() && senza_spazio.eof() && parziale.size()==6);
+
+    std::stringstream dump;
+    for(int i=0; i<50000; ++i)
+        dump<<(i%7000)<<(i%10==0 ? "\n" : "  ");
+    std::vector<std::uint64_t> avanzamento;
+    Set<int, equals_int, std::hash<int> > caricato;
+    std::uint64_t letti=stream_load(dump, caricato, [&avanzamento](std::uint64_t byte, unsigned int){ avanzamento.push_back(byte); }, 4096);
+    assert(letti==50000 && caricato.size()==7000 && caricato[6999]==6999);
+    assert(avanzamento.size()>10 && avanzamento.back()==dump.str().size()); //un blocco alla volta
+
+    Set<std::string, equals_string> parole;
+    std::stringstream frase("audi bmw\taudi fiat\n");
+    assert(stream_load(frase, parole, no_progress(), 3)==4); //blocchi più corti delle parole
+    assert(parole.size()==3 && parole[2]=="fiat");
+
+    const char *file_dump="test_dump.txt";
+    {
+        std::ofstream out(file_dump);
+        out<<caricato;
+    }
+    int fd=open(file_dump, O_RDONLY);
+    assert(fd>=0);
+    Set<int, equals_int, std::hash<int> > da_descrittore;
+    stream_load(fd, da_descrittore, no_progress());
+    close(fd);
+    assert(da_descrittore==caricato);
+    std::remove(file_dump);
+
+    bool lanciata=false;
+    try{
+        std::stringstream rotto("5 6 x");
+        stream_load(rotto, da_descrittore);
+    }catch(std::ios_base::failure &){
+        lanciata=true;
+    }
+    assert(lanciata);
+
+    std::stringstream malformato("1 2 3 x 4");
+    Set<int, equals_int> prima_dell_errore;
+    std::string messaggio;
+    try{
+        stream_load(malformato, prima_dell_errore, no_progress(), 3);
+    }catch(std::ios_base::failure &e){
+        messaggio=e.what();
+    }
+    assert(messaggio.find("at byte 6")!=std::string::npos); //inizio di "x"
+    assert(prima_dell_errore.size()==3); //i blocchi precedenti restano caricati
+    return 0;
+}
+
+/**
+ * @brief Test ricerca eterogenea con funtori trasparenti
+ * 
+ */
+int test_ricerca_eterogenea(){
+    Set<std::string, equals_string_view, hash_string_view> parole;
+    for(int i=0; i<1000; ++i)
+        parole.add("parola-" + std::to_string(i));
+    std::string_view chiave("parola-500");
+    assert(parole.contains(chiave) && parole.contains("parola-999") && !parole.contains(std::string_view("parola")));
+    Set<std::string, equals_string_view, hash_string_view>::const_iterator it=parole.find(chiave);
+    assert(it!=parole.end() && *it=="parola-500" && parole.find("altro")==parole.end());
+    assert(parole.find(std::string("parola-7"))!=parole.end()); //overload non template con T
+    parole.remove(chiave);
+    parole.remove("inesistente");
+    assert(parole.size()==999 && !parole.contains(chiave));
+
+    Set<std::string, equals_string_view> lineare(parole.begin(), parole.end());
+    assert(lineare.contains("parola-0") && lineare.find("parola-1")!=lineare.end());
+    lineare.remove("parola-0");
+    assert(lineare.size()==998 && !lineare.contains("parola-0"));
+
+    Concessionaria c;
+    c.add(Concessionaria::Auto("targa001", "audi"));
+    c.add(Concessionaria::Auto("targa002", "fiat"));
+    assert(c.contains("targa001") && !c.contains("targa003"));
+    c.remove("targa001");
+    assert(!c.contains("targa001") && c.veicoli()==1);
+    return 0;
+}
+
+/**
+ * @brief Vero se S::try_emplace accetta una chiave di tipo K
+ */
+template<typename S, typename K, typename = void>
+struct accetta_try_emplace : std::false_type {};
+template<typename S, typename K>
+struct accetta_try_emplace<S, K, std::void_t<decltype(std::declval<S&>().try_emplace(std::declval<const K&>()))> > : std::true_type {};
+
+/**
+ * @brief Test find, insert e try_emplace
+ * 
+ */
+int test_insert_find(){
+    Set<int, equals_int, std::hash<int> > s;
+    std::pair<Set<int, equals_int, std::hash<int> >::const_iterator, bool> r=s.insert(5);
+    assert(r.second && *r.first==5 && s.size()==1);
+    r=s.insert(5);
+    assert(!r.second && *r.first==5 && s.size()==1);
+    for(int i=0; i<100; ++i)
+        s.insert(i);
+    assert(s.size()==100 && *s.find(42)==42 && s.find(100)==s.end());
+    r=s.insert(7);
+    assert(*r.first==7 && s[0]==5); //l'elemento già presente resta al suo posto
+
+    Set<std::string, equals_string_view, hash_string_view> parole;
+    std::string mossa("spostata");
+    std::pair<Set<std::string, equals_string_view, hash_string_view>::const_iterator, bool> e=parole.insert(std::move(mossa));
+    assert(e.second && mossa.empty());
+    std::string presente("spostata");
+    e=parole.insert(std::move(presente));
+    assert(!e.second && presente=="spostata"); //non spostata se già presente
+    e=parole.try_emplace(std::string_view("abc"));
+    assert(e.second && *e.first=="abc" && parole.size()==2);
+    e=parole.try_emplace("xxx", 3, 'x');
+    assert(e.second && *e.first=="xxx");
+    e=parole.try_emplace("abc", 3, '?'); //già presente: nessuna costruzione
+    assert(!e.second && *e.first=="abc" && parole.size()==3);
+    bool lanciata=false;
+    try{
+        parole.try_emplace("abc?", 3, 'z'); //costruisce "zzz", diverso dalla chiave
+    }catch(std::invalid_argument &){
+        lanciata=true;
+    }
+    assert(lanciata && parole.size()==3 && parole.find("zzz")==parole.end());
+
+    Set<point, equals_point> punti;
+    bool primo=punti.insert(point(1, 2)).second;
+    bool secondo=punti.insert(point(1, 2)).second;
+    assert(primo && !secondo);
+    bool costruito=punti.try_emplace(point(3, 4), 3, 4).second;
+    assert(costruito && punti.find(point(3, 4))!=punti.end() && punti.size()==2);
+
+    //chiavi diverse da T solo con funtori trasparenti: niente T temporanei nascosti
+    static_assert(accetta_try_emplace<Set<std::string, equals_string_view, hash_string_view>, std::string_view>::value);
+    static_assert(!accetta_try_emplace<Set<std::string, equals_string>, std::string_view>::value);
+    static_assert(accetta_try_emplace<Set<std::string, equals_string>, std::string>::value);
+    return 0;
+}
+
+#ifdef SET_INSTRUMENTATION
+/**
+ * @brief Test contatori di Set (solo con -DSET_INSTRUMENTATION, target make instrumented)
+ *
+ */
+int test_instrumentazione(){
+    Set<int, equals_int> lineare;
+    for(int i=1; i<=100; ++i)
+        lineare.add(i);
+    const set_stats &s=lineare.stats();
+    assert(s.equality_comparisons==4950 && s.nodes_traversed==4950); //ogni add scandisce i nodi precedenti
+    assert(s.allocations==100 && s.deallocations==0 && s.add.operations==100);
+
+    lineare.reset_stats();
+    assert(lineare.contains(50) && s.equality_comparisons==50 && s.contains.operations==1);
+    lineare.remove(1);
+    assert(s.equality_comparisons==51 && s.deallocations==1 && s.remove.operations==1);
+    assert(lineare[9]==11 && s.nodes_traversed==61 && s.index.operations==1);
+    assert(lineare[3]==5 && s.nodes_traversed==61); //indice già nella cache
+    lineare.clear();
+    assert(s.deallocations==100);
+
+    Set<int, equals_int> troncato;
+    for(int i=0; i<100; ++i)
+        troncato.add(i);
+    assert(troncato[99]==99);
+    troncato.remove(50);
+    troncato.reset_stats();
+    assert(troncato[98]==99 && troncato.stats().nodes_traversed==49); //solo dalla posizione rimossa in poi
+
+    Set<int, equals_int, std::hash<int> > indicizzato;
+    for(int i=0; i<1000; ++i)
+        indicizzato.add(i);
+    for(int i=0; i<2000; ++i)
+        indicizzato.contains(i);
+    const set_stats &h=indicizzato.stats();
+    assert(h.contains.operations==2000 && h.add.operations==1000);
+    assert(h.equality_comparisons<3*3000); //la tabella tiene corte le sonde
+    assert(h.allocations>1000 && h.allocations-1000==h.deallocations+1); //tabelle: tutte liberate tranne l'ultima
+    unsigned long long classi=0;
+    for(unsigned int i=0; i<latency_histogram::classes; ++i)
+        classi+=h.contains.counts[i];
+    assert(classi==2000 && h.contains.max_ns*2000>=h.contains.total_ns);
+
+    std::stringstream dump;
+    dump<<h;
+    assert(dump.str().find("contains: 2000 op")!=std::string::npos);
+    return 0;
+}
+#endif
+
+/**
+ * @brief Allocatore che conta le allocazioni e le deallocazioni effettuate
+ * 
+ */
+template<typename T>
+struct allocatore_contatore{
+    typedef T value_type;
+    static int allocazioni;///< chiamate ad allocate (comuni a tutti i tipi)
+    static int deallocazioni;///< chiamate a deallocate (comuni a tutti i tipi)
+    static int disponibili;///< allocazioni consentite prima di std::bad_alloc, negativo per nessun limite
+
+    allocatore_contatore() {}
+    template<typename U> allocatore_contatore(const allocatore_contatore<U> &) {}
+
+    T* allocate(std::size_t n){
+        if(allocatore_contatore<char>::disponibili==0)
+            throw std::bad_alloc();
+        if(allocatore_contatore<char>::disponibili>0)
+            --allocatore_contatore<char>::disponibili;
+        ++allocatore_contatore<char>::allocazioni;
+        return static_cast<T*>(::operator new(n*sizeof(T)));
+    }
+    void deallocate(T *p, std::size_t){
+        ++allocatore_contatore<char>::deallocazioni;
+        ::operator delete(p);
+    }
+    template<typename U> bool operator==(const allocatore_contatore<U> &) const { return true; }
+    template<typename U> bool operator!=(const allocatore_contatore<U> &) const { return false; }
+};
+template<typename T> int allocatore_contatore<T>::allocazioni=0;
+template<typename T> int allocatore_contatore<T>::deallocazioni=0;
+template<typename T> int allocatore_contatore<T>::disponibili=-1;
+/**
+ * @brief Test allocazione dei nodi a blocchi tramite node_pool
+ * 
+ */
+int test_node_pool(){
+    typedef allocatore_contatore<char> contatore;
+    {
+        Set<int, equals_int, std::hash<int>, allocatore_contatore<int> > s;
+        for(int i=0; i<100000; ++i)
+            s.add(i);
+        assert(s.size()==100000);
+        //nodi a blocchi (al massimo 4096 per blocco) e tabella raddoppiata: molte meno allocazioni degli elementi
+        assert(contatore::allocazioni < 200);
+        int prima=contatore::allocazioni;
+        for(int i=0; i<1000; ++i)
+            s.remove(i);
+        for(int i=0; i<1000; ++i)
+            s.add(-i-1);
+        assert(contatore::allocazioni==prima); //i nodi rimossi vengono riciclati
+        assert(s.size()==100000 && s.contains(-1000) && !s.contains(999));
+        s.clear();
+        assert(contatore::allocazioni==contatore::deallocazioni);
+        s.add(1);
+        assert(s.size()==1 && s[0]==1);
+    }
+    assert(contatore::allocazioni==contatore::deallocazioni);
+    {
+        Set<std::string, equals_string, no_hash, allocatore_contatore<std::string> > a;
+        for(int i=0; i<100; ++i)
+            a.add(std::to_string(i));
+        Set<std::string, equals_string, no_hash, allocatore_contatore<std::string> > b(a), c;
+        c=b;
+        b.remove("50");
+        assert(a==c && !(a==b));
+        c=std::move(b);
+        assert(c.size()==99 && b.isEmpty());
+        assert(filter_out(a, lenght_equal_4).size()==0);
+        assert((a+c).size()==100 && (a-c).size()==99);
+    }
+    assert(contatore::allocazioni==contatore::deallocazioni);
+    return 0;
+}
+
+/**
+ * @brief Test set con nodi inline (small buffer optimization)
+ * 
+ */
+int test_set_piccoli(){
+    typedef allocatore_contatore<char> contatore;
+    typedef Set<point, equals_point, no_hash, allocatore_contatore<point>, 4> piccolo;
+    int prima=contatore::allocazioni;
+    {
+        point set_of_points[9]={point(-1,-5),point(0,0),point(1,-4),point(-4,-3),point(10,3),point(4,-1),point(-2,1),point(-9,-7),point(2,1)};
+        piccolo setPoint;
+        for(int i=0; i<4; ++i)
+            setPoint.add(set_of_points[i]);
+        assert(setPoint.size()==4 && contatore::allocazioni==prima); //nessuna allocazione
+        piccolo quadrante=filter_out(setPoint, is_located_in_quadrant_4);
+        piccolo copia(quadrante), spostato(std::move(copia));
+        assert(quadrante.size()==2 && spostato==quadrante && copia.isEmpty());
+        copia=spostato;
+        spostato=std::move(quadrante);
+        assert(copia==spostato && quadrante.isEmpty());
+        assert(contatore::allocazioni==prima);
+
+        for(int i=4; i<9; ++i)
+            setPoint.add(set_of_points[i]); //oltre N: i nodi successivi vengono dall'allocatore
+        assert(setPoint.size()==9 && contatore::allocazioni>prima);
+        assert(setPoint[3]==point(-4,-3) && setPoint[8]==point(2,1));
+        setPoint.remove(point(0,0));
+        setPoint.add(point(7,7)); //riusa lo slot inline liberato
+        assert(setPoint.size()==9 && setPoint[8]==point(7,7));
+        piccolo grande(std::move(setPoint));
+        assert(grande.size()==9 && setPoint.isEmpty() && grande[0]==point(-1,-5));
+        grande+=std::move(spostato);
+        assert(grande.size()==9 && spostato.isEmpty());
+        grande.clear();
+        grande.add(point(1,1));
+        assert(grande.size()==1);
+
+        //garanzia forte dell'assegnamento: la copia riesce, i nodi per this no
+        piccolo molti;
+        for(int i=0; i<9; ++i)
+            molti.add(point(i, i));
+        contatore::disponibili=2; //un blocco (intestazione e slot) per la copia temporanea
+        bool lanciata=false;
+        try{
+            grande=molti;
+        }catch(std::bad_alloc &){
+            lanciata=true;
+        }
+        contatore::disponibili=-1;
+        assert(lanciata && grande.size()==1 && grande.contains(point(1,1)));
+        grande=molti;
+        assert(grande==molti && grande[8]==point(8,8));
+    }
+    assert(contatore::allocazioni==contatore::deallocazioni);
+
+    Set<int, equals_int, std::hash<int>, std::allocator<int>, 8> indicizzato;
+    for(int i=0; i<100; ++i)
+        indicizzato.add(i%20);
+    indicizzato.remove(3);
+    assert(indicizzato.size()==19 && !indicizzato.contains(3) && indicizzato.contains(19));
+    Set<int, equals_int, std::hash<int>, std::allocator<int>, 8> altro(std::move(indicizzato));
+    assert(altro.size()==19 && altro.contains(7) && indicizzato.isEmpty());
+
+    Set<Set<int, equals_int, no_hash, std::allocator<int>, 3>, equals_set> insiemi;
+    Set<int, equals_int, no_hash, std::allocator<int>, 3> a, b;
+    a.add(1);
+    a.add(2);
+    b.add(2);
+    b.add(1);
+    insiemi.add(a);
+    insiemi.add(b);
+    assert(insiemi.size()==1 && insiemi[0].size()==2);
+    return 0;
+}
+
 /**
  * @brief Test classe concessionaria
  */
@@ -859,6 +2375,43 @@ int main(){
 
     test_classe_complessa_concessionaria();
 
+    test_remove_add_coda();
+
+    test_set_hash();
+
+    test_vector_set();
+
+    test_simd_contains();
+
+    test_move_semantics();
+
+    test_node_pool();
+
+    test_operator_uguale_lineare();
+
+    test_operazioni_insiemi();
+
+    test_operazioni_sul_posto();
+
+    test_accodamento_senza_duplicati();
+
+    test_filter_out_parallelo();
+
+    test_costruzione_parallela();
+    test_concurrent_set();
+    test_versioned_set();
+    test_operator_parentesi_quadre_costante();
+    test_ordered_set();
+    test_set_piccoli();
+    test_static_set();
+    test_formato_binario();
+    test_caricamento_testuale();
+    test_ricerca_eterogenea();
+    test_insert_find();
+#ifdef SET_INSTRUMENTATION
+    test_instrumentazione();
+#endif
+
 
     return 0;
 }
@@ -0,0 +1,243 @@
+#ifndef NODE_POOL_H
+#define NODE_POOL_H
+#include <cstddef> // std::size_t
+#include <memory> // std::allocator, std::allocator_traits
+#include <utility> // std::swap
+/**
+ * @brief Classe node_pool
+ * 
+ * Arena di nodi di dimensione fissa: la memoria viene chiesta all'allocatore
+ * a blocchi (chunk) di dimensione crescente e i nodi liberati vengono riciclati
+ * tramite una free list, senza restituirli all'allocatore.
+ * release() restituisce tutti i blocchi in una volta sola.
+ * Il pool fornisce solo memoria: costruzione e distruzione dei nodi sono a
+ * carico del chiamante
+ * 
+ * Con Inline > 0 i primi Inline slot sono contenuti nel pool stesso e vengono
+ * usati prima di chiedere memoria all'allocatore: un pool con pochi nodi non
+ * alloca nulla. Poiché i nodi inline vivono dentro l'oggetto, un pool con
+ * Inline > 0 non può essere spostato, scambiato o adottato
+ * 
+ * @tparam Node tipo dei nodi
+ * @tparam Alloc allocatore compatibile con std::allocator (viene fatto il rebind)
+ * @tparam Inline numero di slot contenuti nel pool (default 0: nessuno)
+ */
+template<typename Node, typename Alloc, unsigned int Inline = 0> class node_pool{
+    /**
+     * @brief Slot di un blocco: contiene un nodo oppure il collegamento della free list
+     */
+    union slot{
+        slot *next;///< slot libero successivo
+        alignas(Node) unsigned char storage[sizeof(Node)];///< memoria del nodo
+    };
+    /**
+     * @brief Intestazione di un blocco di slot
+     */
+    struct chunk{
+        chunk *next;///< blocco allocato in precedenza
+        slot *slots;///< array degli slot del blocco
+        std::size_t count;///< numero di slot del blocco
+    };
+    typedef typename std::allocator_traits<Alloc>::template rebind_alloc<slot> slot_allocator;
+    typedef typename std::allocator_traits<Alloc>::template rebind_alloc<chunk> chunk_allocator;
+    typedef std::allocator_traits<slot_allocator> slot_traits;
+    typedef std::allocator_traits<chunk_allocator> chunk_traits;
+
+    /**
+     * @brief Slot inline del pool (nessuno se N == 0)
+     */
+    template<unsigned int N, typename Dummy = void>
+    struct inline_slots{
+        slot slots[N];///< memoria dei nodi inline
+
+        /**
+         * @brief Collega gli slot inline in testa a una free list
+         * 
+         * @param free free list a cui aggiungere gli slot
+         * @return nuova testa della free list
+         */
+        slot* thread(slot *free){
+            for (unsigned int i = N; i > 0; --i){
+                slots[i - 1].next = free;
+                free = &slots[i - 1];
+            }
+            return free;
+        }
+    };
+    template<typename Dummy>
+    struct inline_slots<0, Dummy>{
+        slot* thread(slot *free){
+            return free;
+        }
+    };
+
+    static const std::size_t _first_chunk = 16;///< slot del primo blocco
+    static const std::size_t _max_chunk = 4096;///< slot massimi per blocco
+
+    Alloc _alloc;///< allocatore da cui provengono i blocchi
+    chunk *_chunks;///< lista dei blocchi allocati
+    slot *_free;///< free list degli slot liberi
+    std::size_t _next_chunk;///< dimensione del prossimo blocco
+    inline_slots<Inline> _inline;///< slot contenuti nel pool
+
+    /**
+     * @brief Alloca un nuovo blocco e ne inserisce gli slot nella free list
+     * 
+     * @throw std::bad_alloc possibile eccezione di allocazione, in tal caso il pool non viene alterato
+     */
+    void grow(){
+        slot_allocator sa(_alloc);
+        chunk_allocator ca(_alloc);
+        chunk *c = chunk_traits::allocate(ca, 1);
+        try{
+            c->slots = slot_traits::allocate(sa, _next_chunk);
+        }catch(...){
+            chunk_traits::deallocate(ca, c, 1);
+            throw;
+        }
+        c->count = _next_chunk;
+        c->next = _chunks;
+        _chunks = c;
+        for (std::size_t i = c->count; i > 0; --i){
+            c->slots[i - 1].next = _free;
+            _free = &c->slots[i - 1];
+        }
+        if (_next_chunk < _max_chunk)
+            _next_chunk *= 2;
+    }
+
+    node_pool(const node_pool &);
+    node_pool& operator=(const node_pool &);
+
+public:
+    /**
+     * @brief Costruttore
+     * 
+     * @param alloc allocatore da cui prendere i blocchi
+     * @post nessun blocco allocato
+     */
+    explicit node_pool(const Alloc &alloc = Alloc()) : _alloc(alloc), _chunks(nullptr), _free(nullptr), _next_chunk(_first_chunk){
+        _free = _inline.thread(_free);
+    }
+
+    /**
+     * @brief Move constructor, si appropria dei blocchi di other
+     * 
+     * @param other pool da cui spostare i blocchi
+     */
+    node_pool(node_pool &&other) noexcept : _alloc(other._alloc), _chunks(other._chunks), _free(other._free), _next_chunk(other._next_chunk){
+        static_assert(Inline == 0, "un node_pool con slot inline non può essere spostato");
+        other._chunks = nullptr;
+        other._free = nullptr;
+        other._next_chunk = _first_chunk;
+    }
+    /**
+     * @brief Distruttore, restituisce tutti i blocchi
+     */
+    ~node_pool(){
+        release();
+    }
+    /**
+     * @brief Memoria non inizializzata per un nodo
+     * 
+     * @return puntatore alla memoria del nodo
+     * @throw std::bad_alloc possibile eccezione di allocazione
+     */
+    void* allocate(){
+        if (_free == nullptr)
+            grow();
+        slot *s = _free;
+        _free = s->next;
+        return s->storage;
+    }
+    /**
+     * @brief Garantisce almeno count slot in totale (inline compresi, liberi o in uso)
+     * 
+     * @param count numero di slot
+     * @throw std::bad_alloc possibile eccezione di allocazione, i blocchi già aggiunti restano nel pool
+     */
+    void reserve(std::size_t count){
+        std::size_t slots = Inline;
+        for (chunk *c = _chunks; c != nullptr; c = c->next)
+            slots += c->count;
+        while (slots < count){
+            grow();
+            slots += _chunks->count;
+        }
+    }
+    /**
+     * @brief Rende riutilizzabile la memoria di un nodo già distrutto
+     * 
+     * @param p memoria ottenuta da allocate
+     */
+    void deallocate(void *p){
+        slot *s = static_cast<slot*>(p);
+        s->next = _free;
+        _free = s;
+    }
+    /**
+     * @brief Restituisce in blocco tutta la memoria all'allocatore
+     * 
+     * @pre tutti i nodi allocati sono già stati distrutti
+     */
+    void release(){
+        slot_allocator sa(_alloc);
+        chunk_allocator ca(_alloc);
+        while (_chunks != nullptr){
+            chunk *next = _chunks->next;
+            slot_traits::deallocate(sa, _chunks->slots, _chunks->count);
+            chunk_traits::deallocate(ca, _chunks, 1);
+            _chunks = next;
+        }
+        _free = _inline.thread(nullptr);
+        _next_chunk = _first_chunk;
+    }
+    /**
+     * @brief Acquisisce tutti i blocchi di other, compresi i nodi ancora in uso
+     * 
+     * @param other pool da svuotare, con allocatore uguale a quello di this
+     * @post other non possiede più blocchi
+     */
+    void adopt(node_pool &other){
+        static_assert(Inline == 0, "un node_pool con slot inline non può essere adottato");
+        if (other._chunks != nullptr){
+            chunk *last = other._chunks;
+            while (last->next != nullptr)
+                last = last->next;
+            last->next = _chunks;
+            _chunks = other._chunks;
+        }
+        if (other._free != nullptr){
+            slot *last = other._free;
+            while (last->next != nullptr)
+                last = last->next;
+            last->next = _free;
+            _free = other._free;
+        }
+        other._chunks = nullptr;
+        other._free = nullptr;
+        other._next_chunk = _first_chunk;
+    }
+    /**
+     * @brief Scambia i blocchi e l'allocatore con un altro pool
+     * 
+     * @param other pool con cui fare lo scambio
+     */
+    void swap(node_pool &other){
+        static_assert(Inline == 0, "un node_pool con slot inline non può essere scambiato");
+        std::swap(_alloc, other._alloc);
+        std::swap(_chunks, other._chunks);
+        std::swap(_free, other._free);
+        std::swap(_next_chunk, other._next_chunk);
+    }
+    /**
+     * @brief Allocatore da cui provengono i blocchi
+     * 
+     * @return copia dell'allocatore
+     */
+    Alloc get_allocator() const{
+        return _alloc;
+    }
+};
+
+#endif
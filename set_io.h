@@ -0,0 +1,406 @@
+#ifndef SET_IO_H
+#define SET_IO_H
+#include <cerrno>
+#include <cstdint>
+#include <cstring> // std::memcpy
+#include <ios> // std::ios_base::failure
+#include <istream>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+#include <unistd.h> // read
+#include "Set.h"
+/**
+ * @brief Formato binario dei set
+ *
+ * Il file contiene, nell'ordine e con la rappresentazione nativa della macchina:
+ * 1. binary_header;
+ * 2. gli elementi in ordine di inserimento, codificati da binary_codec<T>;
+ * 3. se table_capacity > 0, una tabella hash a indirizzamento aperto di
+ *    table_capacity uint64_t: ogni slot vale 0 (vuoto) oppure 1 + l'offset in
+ *    byte dell'elemento dall'inizio del punto 2. La tabella viene scritta solo
+ *    per i set indicizzati e permette a MappedSet di rispondere a contains
+ *    senza leggere tutto il file
+ *
+ * La tabella dipende dal funtore hash del set salvato: hash_check combina gli
+ * hash dei primi elementi, così MappedSet può riconoscere un funtore diverso
+ * e ignorare la tabella invece di dare falsi negativi
+ */
+struct binary_header{
+    char magic[4];///< "SETB"
+    std::uint32_t kind;///< 0: elementi di dimensione fissa, 1: stringhe
+    std::uint32_t value_size;///< sizeof(T) per kind 0, 0 per le stringhe
+    std::uint32_t version;///< versione del formato
+    std::uint64_t count;///< numero di elementi
+    std::uint64_t payload_bytes;///< byte occupati dagli elementi
+    std::uint64_t table_capacity;///< slot della tabella hash (potenza di 2), 0 se assente
+    std::uint64_t hash_check;///< impronta del funtore hash (vedi binary_hash_check), 0 senza tabella
+};
+
+static const std::uint32_t binary_format_version = 2;
+static const unsigned int binary_hash_check_values = 8;///< elementi usati da binary_hash_check
+
+/**
+ * @brief Codifica binaria degli elementi di tipo T
+ *
+ * La versione generica copia i byte dei tipi trivially copyable
+ *
+ * @tparam T tipo degli elementi
+ */
+template<typename T>
+struct binary_codec{
+    static_assert(std::is_trivially_copyable<T>::value, "il formato binario richiede T trivially copyable o std::string");
+
+    typedef T mapped_type;///< tipo con cui MappedSet restituisce gli elementi
+    static const std::uint32_t kind = 0;
+    static const std::uint32_t value_size = sizeof(T);
+
+    /**
+     * @brief Byte occupati da un valore
+     */
+    static std::size_t encoded_size(const T &){
+        return sizeof(T);
+    }
+    /**
+     * @brief Scrive un valore sullo stream
+     */
+    static void write(std::ostream &os, const T &value){
+        os.write(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+    /**
+     * @brief Legge un valore dallo stream
+     *
+     * @param remaining byte degli elementi non ancora letti, aggiornato
+     * @throw std::ios_base::failure se il valore supera i byte rimanenti
+     */
+    static T read(std::istream &is, std::uint64_t &remaining){
+        if (remaining < sizeof(T))
+            throw std::ios_base::failure("Corrupt binary set");
+        T value;
+        is.read(reinterpret_cast<char*>(&value), sizeof(T));
+        remaining -= sizeof(T);
+        return value;
+    }
+    /**
+     * @brief Valore codificato a partire da p, senza allocazioni
+     */
+    static mapped_type view(const char *p){
+        T value;
+        std::memcpy(&value, p, sizeof(T));
+        return value;
+    }
+    /**
+     * @brief Byte occupati dal valore codificato a partire da p
+     */
+    static std::size_t mapped_size(const char *){
+        return sizeof(T);
+    }
+    /**
+     * @brief Come mapped_size, ma 0 se il valore non sta negli available byte disponibili
+     */
+    static std::size_t checked_size(const char *, std::uint64_t available){
+        return available < sizeof(T) ? 0 : sizeof(T);
+    }
+};
+
+/**
+ * @brief Codifica delle stringhe: lunghezza (uint32_t) seguita dai caratteri
+ */
+template<>
+struct binary_codec<std::string>{
+    typedef std::string_view mapped_type;
+    static const std::uint32_t kind = 1;
+    static const std::uint32_t value_size = 0;
+
+    static std::size_t encoded_size(const std::string &value){
+        return sizeof(std::uint32_t) + value.size();
+    }
+    static void write(std::ostream &os, const std::string &value){
+        std::uint32_t length = static_cast<std::uint32_t>(value.size());
+        os.write(reinterpret_cast<const char*>(&length), sizeof(length));
+        os.write(value.data(), length);
+    }
+    static std::string read(std::istream &is, std::uint64_t &remaining){
+        std::uint32_t length = 0;
+        if (remaining < sizeof(length))
+            throw std::ios_base::failure("Corrupt binary set");
+        is.read(reinterpret_cast<char*>(&length), sizeof(length));
+        if (!is)
+            return std::string();
+        if (length > remaining - sizeof(length)) //prima di allocare: la lunghezza non è affidabile
+            throw std::ios_base::failure("Corrupt binary set");
+        std::string value(length, '\0');
+        is.read(&value[0], value.size());
+        remaining -= sizeof(length) + length;
+        return value;
+    }
+    static mapped_type view(const char *p){
+        std::uint32_t length;
+        std::memcpy(&length, p, sizeof(length));
+        return std::string_view(p + sizeof(length), length);
+    }
+    static std::size_t mapped_size(const char *p){
+        std::uint32_t length;
+        std::memcpy(&length, p, sizeof(length));
+        return sizeof(length) + length;
+    }
+    static std::size_t checked_size(const char *p, std::uint64_t available){
+        if (available < sizeof(std::uint32_t))
+            return 0;
+        std::size_t size = mapped_size(p);
+        return size > available ? 0 : size;
+    }
+};
+
+/**
+ * @brief Slot di partenza nella tabella del file per un valore hash
+ *
+ * @param h valore del funtore hash
+ * @param capacity numero di slot (potenza di 2)
+ * @return indice dello slot
+ */
+inline std::uint64_t binary_slot(std::size_t h, std::uint64_t capacity){
+    return (static_cast<std::uint64_t>(h) * 0x9E3779B97F4A7C15ULL >> 32) & (capacity - 1);
+}
+
+/**
+ * @brief Impronta di un funtore hash: combina gli hash dei primi elementi di una sequenza
+ *
+ * @param hash funtore hash
+ * @param b iteratore al primo elemento
+ * @param e iteratore di fine
+ * @return impronta, uguale in save e in MappedSet solo se i funtori coincidono sugli elementi
+ */
+template<typename Hash, typename I>
+std::uint64_t binary_hash_check(const Hash &hash, I b, I e){
+    std::uint64_t check = 0x9E3779B97F4A7C15ULL;
+    for (unsigned int i = 0; i < binary_hash_check_values && b != e; ++i, ++b)
+        check = (check ^ static_cast<std::uint64_t>(hash(*b))) * 0xBF58476D1CE4E5B9ULL;
+    return check;
+}
+
+/**
+ * @brief Salva un set in formato binario
+ *
+ * Se il set è indicizzato viene salvata anche la tabella hash usata da MappedSet
+ *
+ * @param s set da salvare
+ * @param os stream binario di output
+ * @throw std::ios_base::failure se la scrittura fallisce
+ */
+template<typename T, typename Eql, typename Hash, typename Alloc, unsigned int N>
+void save(const Set<T, Eql, Hash, Alloc, N> &s, std::ostream &os){
+    typedef binary_codec<T> codec;
+    typedef typename Set<T, Eql, Hash, Alloc, N>::const_iterator iterator;
+    const bool indexed = !std::is_same<Hash, no_hash>::value;
+
+    binary_header h;
+    std::memcpy(h.magic, "SETB", 4);
+    h.kind = codec::kind;
+    h.value_size = codec::value_size;
+    h.version = binary_format_version;
+    h.count = s.size();
+    h.payload_bytes = 0;
+    h.table_capacity = 0;
+    h.hash_check = 0;
+
+    std::vector<std::uint64_t> table;
+    if (indexed && s.size() > 0){
+        h.table_capacity = 16;
+        while (h.table_capacity < 2 * h.count)
+            h.table_capacity *= 2;
+        table.assign(h.table_capacity, 0);
+    }
+    Hash hash;
+    if (!table.empty())
+        h.hash_check = binary_hash_check(hash, s.begin(), s.end());
+    for (iterator b = s.begin(), e = s.end(); b != e; ++b){
+        if (!table.empty()){
+            std::uint64_t slot = binary_slot(hash(*b), h.table_capacity);
+            while (table[slot] != 0)
+                slot = (slot + 1) & (h.table_capacity - 1);
+            table[slot] = h.payload_bytes + 1;
+        }
+        h.payload_bytes += codec::encoded_size(*b);
+    }
+
+    os.write(reinterpret_cast<const char*>(&h), sizeof(h));
+    for (iterator b = s.begin(), e = s.end(); b != e; ++b)
+        codec::write(os, *b);
+    if (!table.empty())
+        os.write(reinterpret_cast<const char*>(table.data()), table.size() * sizeof(std::uint64_t));
+    if (!os)
+        throw std::ios_base::failure("Cannot write the set");
+}
+
+/**
+ * @brief Legge l'intestazione di un file binario e ne verifica la compatibilità con T
+ *
+ * @param is stream binario di input
+ * @return intestazione letta
+ * @throw std::ios_base::failure se l'intestazione è illeggibile o incompatibile
+ */
+template<typename T>
+binary_header read_binary_header(std::istream &is){
+    binary_header h;
+    is.read(reinterpret_cast<char*>(&h), sizeof(h));
+    if (!is || std::memcmp(h.magic, "SETB", 4) != 0 || h.version != binary_format_version)
+        throw std::ios_base::failure("Not a binary set");
+    if (h.kind != binary_codec<T>::kind || h.value_size != binary_codec<T>::value_size)
+        throw std::ios_base::failure("Binary set of a different element type");
+    return h;
+}
+
+/**
+ * @brief Carica in s un set salvato con save
+ *
+ * Ogni elemento viene cercato prima di essere accodato: un file che contiene
+ * due volte lo stesso elemento è corrotto e viene rifiutato. Il caricamento è
+ * O(n) per i set indicizzati, O(n²) per quelli senza indice.
+ * La tabella hash del file viene ignorata
+ *
+ * @param is stream binario di input
+ * @param s set da sostituire con il contenuto del file
+ * @throw std::ios_base::failure se il file è illeggibile, incompatibile o corrotto
+ * (lunghezze che escono dagli elementi dichiarati, elementi duplicati): s non viene alterato
+ * @throw std::bad_alloc possibile eccezione di allocazione
+ */
+template<typename T, typename Eql, typename Hash, typename Alloc, unsigned int N>
+void load(std::istream &is, Set<T, Eql, Hash, Alloc, N> &s){
+    typedef Set<T, Eql, Hash, Alloc, N> set_type;
+    binary_header h = read_binary_header<T>(is);
+    set_type loaded;
+    std::uint64_t remaining = h.payload_bytes;
+    for (std::uint64_t i = 0; i < h.count; ++i){
+        T value = binary_codec<T>::read(is, remaining);
+        if (!is)
+            throw std::ios_base::failure("Truncated binary set");
+        if (!loaded.insert(std::move(value)).second)
+            throw std::ios_base::failure("Corrupt binary set"); //elemento duplicato
+    }
+    if (remaining != 0)
+        throw std::ios_base::failure("Corrupt binary set");
+    s = std::move(loaded);
+}
+
+/**
+ * @brief Funtore di avanzamento che non fa nulla
+ */
+struct no_progress{
+    void operator()(std::uint64_t, unsigned int) const {}
+};
+
+/**
+ * @brief Caricamento testuale a blocchi da una sorgente di byte
+ * 
+ * Ogni blocco letto viene diviso all'ultimo spazio: i valori completi sono
+ * letti con operator>> e aggiunti al set in un'unica volta, il valore spezzato
+ * viene completato dal blocco successivo. In memoria c'è al più un blocco di
+ * testo e i valori che contiene.
+ * Se un valore non può essere letto, i valori dei blocchi precedenti restano
+ * nel set, quelli del blocco che contiene l'errore no
+ * 
+ * @tparam Source funtore (char *buffer, std::size_t n) -> byte letti, 0 alla fine
+ * @tparam P funtore di avanzamento (byte letti, elementi del set)
+ * @return numero di valori letti, duplicati compresi
+ * @throw std::ios_base::failure se un valore non può essere letto; il messaggio
+ * riporta la posizione in byte dell'inizio del token non valido
+ */
+template<typename T, typename Eql, typename Hash, typename Alloc, unsigned int N, typename Source, typename P>
+std::uint64_t load_text_chunks(Set<T, Eql, Hash, Alloc, N> &s, Source read_chunk, std::size_t chunk_bytes, P progress){
+    typedef Set<T, Eql, Hash, Alloc, N> set_type;
+    std::vector<char> buffer(chunk_bytes > 0 ? chunk_bytes : 1);
+    std::string text;
+    std::uint64_t bytes = 0, values = 0;
+    std::uint64_t start = 0; //posizione nella sorgente del primo byte di text
+    std::vector<T> batch;
+    for(;;){
+        std::size_t n = read_chunk(buffer.data(), buffer.size());
+        bytes += n;
+        text.append(buffer.data(), n);
+        std::size_t cut = text.size();
+        if (n > 0){
+            std::size_t space = text.find_last_of(" \t\n\r\f\v");
+            cut = space == std::string::npos ? 0 : space + 1;
+        }
+        std::istringstream parser(text.substr(0, cut));
+        text.erase(0, cut);
+        T value;
+        for(;;){
+            parser >> std::ws;
+            if (parser.eof())
+                break;
+            std::uint64_t token = start + static_cast<std::uint64_t>(parser.tellg());
+            if (!(parser >> value))
+                throw std::ios_base::failure("Malformed value at byte " + std::to_string(token));
+            batch.push_back(std::move(value));
+        }
+        start += cut;
+        values += batch.size();
+        if (!std::is_same<Hash, no_hash>::value && batch.size() >= execution::min_chunk)
+            s += set_type(execution::par, batch.begin(), batch.end()); //duplicati del blocco eliminati in parallelo
+        else
+            for (std::size_t i = 0; i < batch.size(); ++i)
+                s.add(std::move(batch[i]));
+        batch.clear();
+        progress(bytes, s.size());
+        if (n == 0)
+            return values;
+    }
+}
+
+/**
+ * @brief Aggiunge a s i valori testuali letti da uno stream, a blocchi
+ * 
+ * @param is stream di input, letto fino alla fine
+ * @param s set a cui aggiungere i valori (i duplicati vengono ignorati)
+ * @param progress funtore invocato dopo ogni blocco con i byte letti e la dimensione del set
+ * @param chunk_bytes dimensione dei blocchi letti
+ * @return numero di valori letti, duplicati compresi
+ * @throw std::ios_base::failure se lo stream è in errore o un valore non può essere letto
+ * (i valori dei blocchi già caricati restano in s)
+ */
+template<typename T, typename Eql, typename Hash, typename Alloc, unsigned int N, typename P>
+std::uint64_t stream_load(std::istream &is, Set<T, Eql, Hash, Alloc, N> &s, P progress, std::size_t chunk_bytes = 1 << 20){
+    return load_text_chunks(s, [&is](char *p, std::size_t n) -> std::size_t {
+        is.read(p, n);
+        if (is.bad())
+            throw std::ios_base::failure("Cannot read the stream");
+        return static_cast<std::size_t>(is.gcount());
+    }, chunk_bytes, progress);
+}
+/**
+ * @brief Aggiunge a s i valori testuali letti da uno stream, a blocchi, senza avanzamento
+ */
+template<typename T, typename Eql, typename Hash, typename Alloc, unsigned int N>
+std::uint64_t stream_load(std::istream &is, Set<T, Eql, Hash, Alloc, N> &s){
+    return stream_load(is, s, no_progress());
+}
+/**
+ * @brief Aggiunge a s i valori testuali letti da un file descriptor, a blocchi
+ * 
+ * @param fd file descriptor aperto in lettura, letto fino alla fine
+ * @param s set a cui aggiungere i valori (i duplicati vengono ignorati)
+ * @param progress funtore invocato dopo ogni blocco con i byte letti e la dimensione del set
+ * @param chunk_bytes dimensione dei blocchi letti
+ * @return numero di valori letti, duplicati compresi
+ * @throw std::ios_base::failure se la lettura fallisce o un valore non può essere letto
+ * (i valori dei blocchi già caricati restano in s)
+ */
+template<typename T, typename Eql, typename Hash, typename Alloc, unsigned int N, typename P>
+std::uint64_t stream_load(int fd, Set<T, Eql, Hash, Alloc, N> &s, P progress, std::size_t chunk_bytes = 1 << 20){
+    return load_text_chunks(s, [fd](char *p, std::size_t n) -> std::size_t {
+        for(;;){
+            ssize_t r = ::read(fd, p, n);
+            if (r >= 0)
+                return static_cast<std::size_t>(r);
+            if (errno != EINTR)
+                throw std::ios_base::failure("Cannot read the file descriptor");
+        }
+    }, chunk_bytes, progress);
+}
+
+#endif
@@ -0,0 +1,139 @@
+#ifndef SET_STATS_H
+#define SET_STATS_H
+#include <chrono>
+#include <ostream>
+/**
+ * @brief Strumentazione opzionale di Set
+ *
+ * Compilando con -DSET_INSTRUMENTATION ogni Set conta confronti di
+ * uguaglianza, nodi e slot visitati, allocazioni e deallocazioni, e registra
+ * la latenza di add, remove, contains e operator[] in istogrammi; i dati sono
+ * disponibili tramite Set::stats(). Senza la macro SET_STAT si espande nel
+ * nulla: nessun membro aggiuntivo e nessun costo
+ */
+#ifdef SET_INSTRUMENTATION
+#define SET_STAT(statement) statement
+#else
+#define SET_STAT(statement)
+#endif
+
+/**
+ * @brief Istogramma delle latenze con classi a potenze di 2
+ *
+ * La classe i conta le operazioni durate tra 2^i e 2^(i+1)-1 nanosecondi
+ */
+struct latency_histogram{
+    static const unsigned int classes = 40;///< numero di classi (fino a circa 18 minuti)
+    unsigned long long counts[classes];///< operazioni per classe
+    unsigned long long operations;///< operazioni registrate
+    unsigned long long total_ns;///< somma delle latenze
+    unsigned long long max_ns;///< latenza massima
+
+    latency_histogram(){
+        reset();
+    }
+    /**
+     * @brief Azzera l'istogramma
+     */
+    void reset(){
+        for (unsigned int i = 0; i < classes; ++i)
+            counts[i] = 0;
+        operations = 0;
+        total_ns = 0;
+        max_ns = 0;
+    }
+    /**
+     * @brief Registra la latenza di un'operazione
+     *
+     * @param ns durata in nanosecondi
+     */
+    void record(unsigned long long ns){
+        unsigned int c = 0;
+        while (c + 1 < classes && (ns >> (c + 1)) != 0)
+            c++;
+        counts[c]++;
+        operations++;
+        total_ns += ns;
+        if (ns > max_ns)
+            max_ns = ns;
+    }
+    /**
+     * @brief Operatore di stream: operazioni, media, massimo e classi non vuote
+     * @param os stream di output
+     * @param h istogramma da spedire sullo stream
+     * @return reference dello stream di output
+     */
+    friend std::ostream& operator<<(std::ostream &os, const latency_histogram &h){
+        os<<h.operations<<" op";
+        if (h.operations == 0)
+            return os;
+        os<<", media "<<h.total_ns / h.operations<<" ns, max "<<h.max_ns<<" ns [";
+        for (unsigned int i = 0; i < classes; ++i)
+            if (h.counts[i] != 0)
+                os<<" <"<<(2ULL << i)<<"ns:"<<h.counts[i];
+        return os<<" ]";
+    }
+};
+
+/**
+ * @brief Contatori di un Set strumentato
+ */
+struct set_stats{
+    unsigned long long equality_comparisons;///< invocazioni di Eql durante le ricerche
+    unsigned long long nodes_traversed;///< nodi della lista e slot della tabella visitati
+    unsigned long long allocations;///< nodi e tabelle allocati
+    unsigned long long deallocations;///< nodi e tabelle rilasciati
+    latency_histogram add;///< latenze di add ed emplace
+    latency_histogram remove;///< latenze di remove
+    latency_histogram contains;///< latenze di contains
+    latency_histogram index;///< latenze di operator[]
+
+    set_stats(){
+        reset();
+    }
+    /**
+     * @brief Azzera tutti i contatori
+     */
+    void reset(){
+        equality_comparisons = 0;
+        nodes_traversed = 0;
+        allocations = 0;
+        deallocations = 0;
+        add.reset();
+        remove.reset();
+        contains.reset();
+        index.reset();
+    }
+    /**
+     * @brief Operatore di stream
+     * @param os stream di output
+     * @param s contatori da spedire sullo stream
+     * @return reference dello stream di output
+     */
+    friend std::ostream& operator<<(std::ostream &os, const set_stats &s){
+        return os<<"confronti: "<<s.equality_comparisons<<", nodi visitati: "<<s.nodes_traversed
+                 <<", allocazioni: "<<s.allocations<<", deallocazioni: "<<s.deallocations
+                 <<"\nadd: "<<s.add<<"\nremove: "<<s.remove<<"\ncontains: "<<s.contains
+                 <<"\noperator[]: "<<s.index<<"\n";
+    }
+};
+
+/**
+ * @brief Registra in un istogramma la durata del blocco in cui è dichiarato
+ */
+class scoped_latency{
+    latency_histogram &_histogram;///< istogramma da aggiornare
+    std::chrono::steady_clock::time_point _start;///< inizio dell'operazione
+
+    scoped_latency(const scoped_latency &);
+    scoped_latency& operator=(const scoped_latency &);
+
+public:
+    explicit scoped_latency(latency_histogram &h) : _histogram(h), _start(std::chrono::steady_clock::now()) {}
+    ~scoped_latency(){
+        _histogram.record(static_cast<unsigned long long>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - _start).count()));
+    }
+};
+
+#endif
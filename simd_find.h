@@ -0,0 +1,235 @@
+#ifndef SIMD_FIND_H
+#define SIMD_FIND_H
+#include <cstddef> // std::size_t
+#include <cstring> // std::memcpy
+#include <functional> // std::equal_to
+#include <type_traits> // std::is_integral, std::is_floating_point
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+/**
+ * @brief Trait che indica se il funtore Eql coincide con operator== su T
+ * 
+ * Solo in questo caso la ricerca può confrontare i bit dei valori a blocchi
+ * con istruzioni SIMD. Di default vale false; è true per std::equal_to<T> e
+ * può essere specializzato per i funtori di uguaglianza dell'utente
+ * 
+ * @tparam Eql funtore di uguaglianza
+ * @tparam T tipo degli elementi
+ */
+template<typename Eql, typename T>
+struct is_plain_equality : std::false_type {};
+
+template<typename T>
+struct is_plain_equality<std::equal_to<T>, T> : std::true_type {};
+
+/**
+ * @brief Indice del bit meno significativo a 1
+ * 
+ * @param mask maschera diversa da 0
+ * @return posizione del bit
+ */
+inline unsigned int lowest_bit(unsigned int mask){
+#if defined(__GNUC__)
+    return static_cast<unsigned int>(__builtin_ctz(mask));
+#else
+    unsigned int i = 0;
+    while ((mask & 1u) == 0){
+        mask >>= 1;
+        i++;
+    }
+    return i;
+#endif
+}
+
+/**
+ * @brief Kernel di ricerca lineare vettorizzato
+ * 
+ * La versione generica è scalare; le specializzazioni per tipi interi
+ * di 1, 2, 4, 8 byte e per float/double confrontano 16 (SSE2) o 32 (AVX2)
+ * byte per istruzione e usano la maschera del confronto per individuare
+ * il primo elemento uguale
+ * 
+ * @tparam T tipo aritmetico degli elementi
+ */
+template<typename T, bool Integral = std::is_integral<T>::value, std::size_t Bytes = sizeof(T)>
+struct simd_kernel{
+    /**
+     * @brief Scansione vettoriale (nulla nella versione generica)
+     * 
+     * @param data array degli elementi
+     * @param n numero di elementi
+     * @param value valore da cercare
+     * @param found impostato a true se value è stato trovato
+     * @return indice dell'elemento trovato, altrimenti numero di elementi già esaminati
+     */
+    static unsigned int scan(const T *, unsigned int, T, bool &found){
+        found = false;
+        return 0;
+    }
+};
+
+#if defined(__SSE2__)
+/**
+ * @brief Confronto a blocchi di interi larghi Bytes byte
+ */
+template<typename T, std::size_t Bytes>
+struct simd_integral_kernel{
+    static __m128i splat(T value){
+        switch (Bytes){
+            case 1: { char v; std::memcpy(&v, &value, 1); return _mm_set1_epi8(v); }
+            case 2: { short v; std::memcpy(&v, &value, 2); return _mm_set1_epi16(v); }
+            case 4: { int v; std::memcpy(&v, &value, 4); return _mm_set1_epi32(v); }
+            default: { long long v; std::memcpy(&v, &value, 8); return _mm_set1_epi64x(v); }
+        }
+    }
+    static __m128i cmpeq(__m128i a, __m128i b){
+        switch (Bytes){
+            case 1: return _mm_cmpeq_epi8(a, b);
+            case 2: return _mm_cmpeq_epi16(a, b);
+            case 4: return _mm_cmpeq_epi32(a, b);
+            default: {
+                //SSE2 non ha cmpeq a 64 bit: entrambe le metà a 32 bit devono coincidere
+                __m128i c = _mm_cmpeq_epi32(a, b);
+                return _mm_and_si128(c, _mm_shuffle_epi32(c, _MM_SHUFFLE(2, 3, 0, 1)));
+            }
+        }
+    }
+#if defined(__AVX2__)
+    static __m256i splat256(T value){
+        switch (Bytes){
+            case 1: { char v; std::memcpy(&v, &value, 1); return _mm256_set1_epi8(v); }
+            case 2: { short v; std::memcpy(&v, &value, 2); return _mm256_set1_epi16(v); }
+            case 4: { int v; std::memcpy(&v, &value, 4); return _mm256_set1_epi32(v); }
+            default: { long long v; std::memcpy(&v, &value, 8); return _mm256_set1_epi64x(v); }
+        }
+    }
+    static __m256i cmpeq256(__m256i a, __m256i b){
+        switch (Bytes){
+            case 1: return _mm256_cmpeq_epi8(a, b);
+            case 2: return _mm256_cmpeq_epi16(a, b);
+            case 4: return _mm256_cmpeq_epi32(a, b);
+            default: return _mm256_cmpeq_epi64(a, b);
+        }
+    }
+#endif
+    static unsigned int scan(const T *data, unsigned int n, T value, bool &found){
+        unsigned int i = 0;
+        found = false;
+#if defined(__AVX2__)
+        const unsigned int lanes256 = 32 / Bytes;
+        const __m256i needle256 = splat256(value);
+        for (; i + lanes256 <= n; i += lanes256){
+            __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+            unsigned int mask = static_cast<unsigned int>(_mm256_movemask_epi8(cmpeq256(block, needle256)));
+            if (mask != 0){
+                found = true;
+                return i + lowest_bit(mask) / Bytes;
+            }
+        }
+#endif
+        const unsigned int lanes = 16 / Bytes;
+        const __m128i needle = splat(value);
+        for (; i + lanes <= n; i += lanes){
+            __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+            unsigned int mask = static_cast<unsigned int>(_mm_movemask_epi8(cmpeq(block, needle)));
+            if (mask != 0){
+                found = true;
+                return i + lowest_bit(mask) / Bytes;
+            }
+        }
+        return i;
+    }
+};
+
+template<typename T> struct simd_kernel<T, true, 1> : simd_integral_kernel<T, 1> {};
+template<typename T> struct simd_kernel<T, true, 2> : simd_integral_kernel<T, 2> {};
+template<typename T> struct simd_kernel<T, true, 4> : simd_integral_kernel<T, 4> {};
+template<typename T> struct simd_kernel<T, true, 8> : simd_integral_kernel<T, 8> {};
+
+/**
+ * @brief Confronto a blocchi di float (uguaglianza IEEE, come operator==)
+ */
+template<>
+struct simd_kernel<float, false, 4>{
+    static unsigned int scan(const float *data, unsigned int n, float value, bool &found){
+        unsigned int i = 0;
+        found = false;
+#if defined(__AVX2__)
+        const __m256 needle256 = _mm256_set1_ps(value);
+        for (; i + 8 <= n; i += 8){
+            unsigned int mask = static_cast<unsigned int>(_mm256_movemask_ps(_mm256_cmp_ps(_mm256_loadu_ps(data + i), needle256, _CMP_EQ_OQ)));
+            if (mask != 0){
+                found = true;
+                return i + lowest_bit(mask);
+            }
+        }
+#endif
+        const __m128 needle = _mm_set1_ps(value);
+        for (; i + 4 <= n; i += 4){
+            unsigned int mask = static_cast<unsigned int>(_mm_movemask_ps(_mm_cmpeq_ps(_mm_loadu_ps(data + i), needle)));
+            if (mask != 0){
+                found = true;
+                return i + lowest_bit(mask);
+            }
+        }
+        return i;
+    }
+};
+
+/**
+ * @brief Confronto a blocchi di double (uguaglianza IEEE, come operator==)
+ */
+template<>
+struct simd_kernel<double, false, 8>{
+    static unsigned int scan(const double *data, unsigned int n, double value, bool &found){
+        unsigned int i = 0;
+        found = false;
+#if defined(__AVX2__)
+        const __m256d needle256 = _mm256_set1_pd(value);
+        for (; i + 4 <= n; i += 4){
+            unsigned int mask = static_cast<unsigned int>(_mm256_movemask_pd(_mm256_cmp_pd(_mm256_loadu_pd(data + i), needle256, _CMP_EQ_OQ)));
+            if (mask != 0){
+                found = true;
+                return i + lowest_bit(mask);
+            }
+        }
+#endif
+        const __m128d needle = _mm_set1_pd(value);
+        for (; i + 2 <= n; i += 2){
+            unsigned int mask = static_cast<unsigned int>(_mm_movemask_pd(_mm_cmpeq_pd(_mm_loadu_pd(data + i), needle)));
+            if (mask != 0){
+                found = true;
+                return i + lowest_bit(mask);
+            }
+        }
+        return i;
+    }
+};
+#endif
+
+/**
+ * @brief Cerca value in un array di tipo aritmetico usando i kernel SIMD
+ * disponibili e completando con una scansione scalare
+ * 
+ * @tparam T tipo aritmetico degli elementi
+ * @param data array degli elementi
+ * @param n numero di elementi
+ * @param value valore da cercare
+ * @return indice del primo elemento uguale a value, n se non presente
+ */
+template<typename T>
+unsigned int simd_find(const T *data, unsigned int n, T value){
+    bool found;
+    unsigned int i = simd_kernel<T>::scan(data, n, value, found);
+    if (found)
+        return i;
+    for (; i < n; ++i)
+        if (data[i] == value)
+            return i;
+    return n;
+}
+
+#endif